@@ -48,6 +48,18 @@ ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${LOCK_PROFILING},1)
+BL31_SOURCES		+=	lib/locks/lock_prof.c
+endif
+
+ifeq (${SMC_ACCOUNTING},1)
+BL31_SOURCES		+=	common/runtime_svc_acct.c
+endif
+
+ifeq (${SMC_BATCH},1)
+BL31_SOURCES		+=	common/runtime_svc_batch.c
+endif
+
 include lib/debugfs/debugfs.mk
 ifeq (${USE_DEBUGFS},1)
 	BL31_SOURCES	+= $(DEBUGFS_SRCS)
@@ -141,6 +141,11 @@ int32_t set_routing_model(uint32_t type, uint32_t flags)
 	set_scr_el3_from_rm(type, flags, SECURE);
 	set_scr_el3_from_rm(type, flags, NON_SECURE);
 
+#if WARMBOOT_GOLDEN_CTX
+	/* The golden contexts hold SCR_EL3 values of the old routing model */
+	cm_invalidate_golden_ctx();
+#endif
+
 	return 0;
 }
 
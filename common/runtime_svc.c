@@ -10,6 +10,10 @@
 
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <plat/common/platform.h>
+#include <services/arm_arch_svc.h>
+#include <services/std_svc.h>
+#include <services/trng_svc.h>
 
 /*******************************************************************************
  * The 'rt_svc_descs' array holds the runtime service descriptors exported by
@@ -55,6 +59,98 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 						handle, flags);
 }
 
+/*******************************************************************************
+ * Build the second level dispatch table of a runtime service from its list of
+ * function number ranges. Each range is entered for the calling conventions it
+ * is given, so that e.g. the SMC64 alias of an SMC32 only function is not
+ * found. Returns -ENOMEM if the ranges span more blocks than the table was
+ * defined with.
+ ******************************************************************************/
+int rt_svc_fid_table_init(rt_svc_fid_table_t *table)
+{
+	const rt_svc_fid_range_t *range;
+	unsigned int i, cc, fnum, key, num_blocks = 0U;
+	uint8_t *block;
+
+	assert(table->num_ranges < RT_SVC_FID_NONE);
+	assert(table->num_blocks < RT_SVC_FID_NONE);
+
+	(void)memset(table->block_idx, RT_SVC_FID_NONE,
+		     sizeof(table->block_idx));
+
+	for (i = 0U; i < table->num_ranges; i++) {
+		range = &table->ranges[i];
+		assert(range->first <= range->last);
+		assert(range->cc <= RT_SVC_FID_CC_SMC64);
+		assert(range->handle != NULL);
+
+		for (cc = SMC_32; cc <= SMC_64; cc++) {
+			if (((range->cc == RT_SVC_FID_CC_SMC32) &&
+			     (cc != SMC_32)) ||
+			    ((range->cc == RT_SVC_FID_CC_SMC64) &&
+			     (cc != SMC_64)))
+				continue;
+
+			for (fnum = range->first; fnum <= range->last; fnum++) {
+				uint8_t *idx;
+
+				key = RT_SVC_FID_KEY(cc, fnum);
+				idx = &table->block_idx[key >>
+						RT_SVC_FID_BLOCK_SHIFT];
+
+				if (*idx == RT_SVC_FID_NONE) {
+					if (num_blocks == table->num_blocks)
+						return -ENOMEM;
+
+					*idx = (uint8_t)num_blocks++;
+					(void)memset(table->blocks[*idx],
+						     RT_SVC_FID_NONE,
+						     RT_SVC_FID_BLOCK_SIZE);
+				}
+
+				block = table->blocks[*idx];
+				block[key & (RT_SVC_FID_BLOCK_SIZE - 1U)] =
+					(uint8_t)i;
+			}
+		}
+	}
+
+	return 0;
+}
+
+#if SMC_LIGHT_ENTRY
+/*******************************************************************************
+ * Tell smc_handler64 whether the handler of the fast SMC 'smc_fid' never
+ * switches worlds nor reads the caller's x19-x29 from its context, in which
+ * case those registers are neither saved nor restored around it. Platforms
+ * extend the list for their SiP and OEM services through plat_is_light_smc().
+ * smc_handler64 only asks for fast SMCs below OEN_TAP_START.
+ ******************************************************************************/
+bool rt_svc_is_light_smc(uint32_t smc_fid)
+{
+	switch (smc_fid) {
+	case SMCCC_VERSION:
+	case SMCCC_ARCH_FEATURES:
+	case SMCCC_ARCH_SOC_ID:
+	case SMCCC_ARCH_WORKAROUND_1:
+	case SMCCC_ARCH_WORKAROUND_2:
+	case ARM_STD_SVC_CALL_COUNT:
+	case ARM_STD_SVC_UID:
+	case ARM_STD_SVC_VERSION:
+#if TRNG_SUPPORT
+	case ARM_TRNG_VERSION:
+	case ARM_TRNG_FEATURES:
+	case ARM_TRNG_GET_UUID:
+	case ARM_TRNG_RND32:
+	case ARM_TRNG_RND64:
+#endif
+		return true;
+	default:
+		return plat_is_light_smc(smc_fid);
+	}
+}
+#endif /* SMC_LIGHT_ENTRY */
+
 /*******************************************************************************
  * Simple routine to sanity check a runtime service descriptor before using it
  ******************************************************************************/
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*******************************************************************************
+ * Accounting of the SMCs dispatched by smc_handler64. Every cpu counts the
+ * calls it handles per unique OEN and, for up to SMC_ACCOUNTING_FIDS distinct
+ * function IDs, keeps a call count, the total time spent in the handler and a
+ * log2 histogram of that time in ticks of the system counter. FIDs are kept
+ * in an open addressed hash table; calls to FIDs which find the table full
+ * are only counted per OEN and as untracked.
+ *
+ * The statistics are only written by the cpu they belong to. Readers on other
+ * cpus get a snapshot which may be torn across an update in flight.
+ ******************************************************************************/
+#include <assert.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/runtime_svc.h>
+#include <common/runtime_svc_acct.h>
+#include <lib/smccc.h>
+#include <plat/common/platform.h>
+
+smc_acct_cpu_t smc_acct_stats[PLATFORM_CORE_COUNT];
+
+static unsigned int smc_acct_hash(uint32_t key)
+{
+	/* Fibonacci hashing, the upper bits are the best mixed */
+	return (unsigned int)((key * 0x9e3779b1U) >> 16) &
+		(SMC_ACCOUNTING_FIDS - 1U);
+}
+
+static smc_acct_fid_t *smc_acct_lookup(smc_acct_cpu_t *stats, uint32_t key)
+{
+	smc_acct_fid_t *slot;
+	unsigned int i, idx = smc_acct_hash(key);
+
+	for (i = 0U; i < SMC_ACCOUNTING_FIDS; i++) {
+		slot = &stats->fids[idx];
+		if (slot->count == 0U) {
+			slot->fid = key;
+			return slot;
+		}
+		if (slot->fid == key)
+			return slot;
+
+		idx = (idx + 1U) & (SMC_ACCOUNTING_FIDS - 1U);
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * Account for an SMC which was dispatched to the handler of 'oen_idx' at time
+ * 'start' and has just returned. 'imm' is the immediate of the SMC
+ * instruction. Called by smc_handler64 on the runtime stack.
+ ******************************************************************************/
+void smc_acct_record(uint32_t smc_fid, uint32_t imm, uint32_t oen_idx,
+		     uint64_t start)
+{
+	smc_acct_cpu_t *stats = &smc_acct_stats[plat_my_core_pos()];
+	smc_acct_fid_t *slot;
+	uint64_t ticks = read_cntpct_el0() - start;
+	uint32_t bucket;
+
+	assert(oen_idx < MAX_RT_SVCS);
+	stats->oen_count[oen_idx]++;
+
+	slot = smc_acct_lookup(stats, (imm != 0U) ?
+			       SMC_ACCT_IMM_KEY(imm) : smc_fid);
+	if (slot == NULL) {
+		stats->untracked++;
+		return;
+	}
+
+	bucket = (ticks == 0U) ? 0U : (63U - __builtin_clzll(ticks));
+	if (bucket >= SMC_ACCT_HIST_BUCKETS)
+		bucket = SMC_ACCT_HIST_BUCKETS - 1U;
+
+	slot->count++;
+	slot->ticks += ticks;
+	slot->hist[bucket]++;
+}
+
+/*******************************************************************************
+ * Handle the SiP call reading the accounting data, see runtime_svc_acct.h.
+ ******************************************************************************/
+uintptr_t smc_acct_smc_handler(unsigned int smc_fid,
+			       u_register_t cmd,
+			       u_register_t x2,
+			       u_register_t x3,
+			       u_register_t x4,
+			       void *cookie,
+			       void *handle,
+			       u_register_t flags)
+{
+	const smc_acct_cpu_t *stats;
+	const smc_acct_fid_t *slot;
+	uint64_t bkt[SMC_ACCT_BUCKETS_PER_CALL] = { 0 };
+	int core_pos;
+	unsigned int i;
+
+	core_pos = plat_core_pos_by_mpidr(x2);
+	if (core_pos < 0)
+		SMC_RET1(handle, SMC_UNK);
+
+	stats = &smc_acct_stats[core_pos];
+
+	switch (cmd) {
+	case SMC_ACCT_INFO:
+		SMC_RET5(handle, SMC_OK, SMC_ACCOUNTING_FIDS,
+			 SMC_ACCT_HIST_BUCKETS, stats->untracked,
+			 read_cntfrq_el0());
+
+	case SMC_ACCT_OEN:
+		if (x3 >= MAX_RT_SVCS)
+			break;
+
+		SMC_RET2(handle, SMC_OK, stats->oen_count[x3]);
+
+	case SMC_ACCT_FID:
+		if ((x3 >= SMC_ACCOUNTING_FIDS) ||
+		    (x4 >= SMC_ACCT_HIST_BUCKETS))
+			break;
+
+		slot = &stats->fids[x3];
+		for (i = 0U; i < SMC_ACCT_BUCKETS_PER_CALL; i++) {
+			if ((x4 + i) < SMC_ACCT_HIST_BUCKETS)
+				bkt[i] = slot->hist[x4 + i];
+		}
+
+		SMC_RET8(handle, SMC_OK, slot->fid, slot->count, slot->ticks,
+			 bkt[0], bkt[1], bkt[2], bkt[3]);
+
+	default:
+		break;
+	}
+
+	SMC_RET1(handle, SMC_UNK);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*******************************************************************************
+ * SMC batching. Every cpu of the normal world may register a buffer holding a
+ * vector of smc_batch_entry_t, and then have any number of its entries issued
+ * back to back with a single SMC_BATCH_RUN. Each SMC is dispatched through
+ * handle_runtime_svc() with a synthetic context which only holds the general
+ * purpose registers: the handler gets its arguments from there and leaves its
+ * results there, which are then copied back into the entry.
+ *
+ * Only the SMCs whose handlers do no more than that can be batched, i.e. those
+ * which neither switch worlds, nor return to a different place, nor look at
+ * any other part of the caller's context. They are listed below, and
+ * platforms add their own through plat_is_batchable_smc().
+ *
+ * A buffer is only mapped once plat_smc_batch_validate_buf() has checked that
+ * it lies in Non-secure DRAM.
+ ******************************************************************************/
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/runtime_svc.h>
+#include <common/runtime_svc_batch.h>
+#include <context.h>
+#include <lib/lock_prof.h>
+#include <lib/psci/psci.h>
+#include <lib/spinlock.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+#include <plat/common/platform.h>
+#include <services/arm_arch_svc.h>
+#include <services/sdei.h>
+#include <services/std_svc.h>
+#include <services/trng_svc.h>
+
+#include <platform_def.h>
+
+#if !PLAT_XLAT_TABLES_DYNAMIC
+#error "SMC_BATCH requires PLAT_XLAT_TABLES_DYNAMIC"
+#endif
+
+/* The synthetic context only has room for the general purpose registers */
+CASSERT(CTX_GPREGS_OFFSET == 0U, assert_smc_batch_gpregs_not_first);
+
+typedef struct smc_batch_buf {
+	uintptr_t va;
+	size_t size;
+} smc_batch_buf_t;
+
+static smc_batch_buf_t smc_batch_bufs[PLATFORM_CORE_COUNT];
+
+/* Serialises the updates of the translation tables */
+static spinlock_t smc_batch_map_lock;
+REGISTER_LOCK_PROF_LOCK(smc_batch_map_lock);
+
+static bool smc_batch_is_batchable(uint32_t smc_fid)
+{
+	switch (smc_fid) {
+	case SMCCC_VERSION:
+	case SMCCC_ARCH_FEATURES:
+	case SMCCC_ARCH_SOC_ID:
+	case ARM_STD_SVC_CALL_COUNT:
+	case ARM_STD_SVC_UID:
+	case ARM_STD_SVC_VERSION:
+	case PSCI_VERSION:
+	case PSCI_FEATURES:
+	case PSCI_AFFINITY_INFO_AARCH32:
+	case PSCI_AFFINITY_INFO_AARCH64:
+	case PSCI_MIG_INFO_TYPE:
+	case PSCI_NODE_HW_STATE_AARCH32:
+	case PSCI_NODE_HW_STATE_AARCH64:
+#if ENABLE_PSCI_STAT
+	case PSCI_STAT_RESIDENCY_AARCH32:
+	case PSCI_STAT_RESIDENCY_AARCH64:
+	case PSCI_STAT_COUNT_AARCH32:
+	case PSCI_STAT_COUNT_AARCH64:
+#endif
+#if SDEI_SUPPORT
+	case SDEI_VERSION:
+	case SDEI_EVENT_REGISTER:
+	case SDEI_EVENT_ENABLE:
+	case SDEI_EVENT_DISABLE:
+	case SDEI_EVENT_UNREGISTER:
+	case SDEI_EVENT_STATUS:
+	case SDEI_EVENT_GET_INFO:
+	case SDEI_EVENT_ROUTING_SET:
+	case SDEI_INTERRUPT_BIND:
+	case SDEI_INTERRUPT_RELEASE:
+	case SDEI_FEATURES:
+#endif
+#if TRNG_SUPPORT
+	case ARM_TRNG_VERSION:
+	case ARM_TRNG_FEATURES:
+	case ARM_TRNG_GET_UUID:
+	case ARM_TRNG_RND32:
+	case ARM_TRNG_RND64:
+#endif
+		return true;
+	default:
+		return plat_is_batchable_smc(smc_fid);
+	}
+}
+
+static void smc_batch_unmap(smc_batch_buf_t *buf)
+{
+	int rc;
+
+	if (buf->size == 0U)
+		return;
+
+	rc = mmap_remove_dynamic_region(buf->va, buf->size);
+	assert(rc == 0);
+	(void)rc;
+
+	buf->size = 0U;
+}
+
+static int smc_batch_register(smc_batch_buf_t *buf, u_register_t pa,
+			      u_register_t size)
+{
+	uintptr_t va;
+	int rc;
+
+	if (((pa & PAGE_SIZE_MASK) != 0U) || ((size & PAGE_SIZE_MASK) != 0U) ||
+	    (size == 0U) || (size > SMC_BATCH_MAX_BUF_SIZE))
+		return SMC_BATCH_E_INVALID_PARAMS;
+
+	if (plat_smc_batch_validate_buf(pa, size) != 0)
+		return SMC_BATCH_E_INVALID_PARAMS;
+
+	spin_lock(&smc_batch_map_lock);
+
+	smc_batch_unmap(buf);
+
+	/* Mapped as non-secure, as an extra guard against reaching secure memory */
+	rc = mmap_add_dynamic_region_alloc_va(pa, &va, size,
+					      MT_MEMORY | MT_RW | MT_NS);
+	if (rc == 0) {
+		buf->va = va;
+		buf->size = size;
+	}
+
+	spin_unlock(&smc_batch_map_lock);
+
+	if (rc != 0)
+		return SMC_BATCH_E_INVALID_PARAMS;
+
+	return SMC_OK;
+}
+
+/*******************************************************************************
+ * Issue the SMCs of entries [first, first + count) of 'buf' on behalf of a
+ * caller in the security state given by 'flags'.
+ ******************************************************************************/
+static int smc_batch_run(const smc_batch_buf_t *buf, u_register_t first,
+			 u_register_t count, u_register_t flags)
+{
+	smc_batch_entry_t *entry;
+	gp_regs_t ctx;
+	uint32_t smc_fid;
+	u_register_t i, num_entries = buf->size / sizeof(smc_batch_entry_t);
+	unsigned int j;
+
+	if ((first > num_entries) || (count > (num_entries - first)))
+		return SMC_BATCH_E_INVALID_PARAMS;
+
+	for (i = 0U; i < count; i++) {
+		entry = &((smc_batch_entry_t *)buf->va)[first + i];
+
+		/* The normal world may change the entry under our feet */
+		for (j = 0U; j < 8U; j++)
+			write_ctx_reg(&ctx, CTX_GPREG_X0 + (j << 3),
+				      entry->args[j]);
+
+		smc_fid = (uint32_t)read_ctx_reg(&ctx, CTX_GPREG_X0);
+		if (smc_batch_is_batchable(smc_fid)) {
+			(void)handle_runtime_svc(smc_fid, NULL, &ctx,
+						 (unsigned int)flags);
+		} else {
+			write_ctx_reg(&ctx, CTX_GPREG_X0, SMC_UNK);
+		}
+
+		for (j = 0U; j < 8U; j++)
+			entry->res[j] = read_ctx_reg(&ctx,
+						     CTX_GPREG_X0 + (j << 3));
+	}
+
+	return SMC_OK;
+}
+
+/*******************************************************************************
+ * Handle the SiP call issuing SMC batches, see runtime_svc_batch.h.
+ ******************************************************************************/
+uintptr_t smc_batch_smc_handler(unsigned int smc_fid,
+				u_register_t cmd,
+				u_register_t x2,
+				u_register_t x3,
+				u_register_t x4,
+				void *cookie,
+				void *handle,
+				u_register_t flags)
+{
+	smc_batch_buf_t *buf = &smc_batch_bufs[plat_my_core_pos()];
+	int rc;
+
+	/* Allow SMC64 calls from non-secure only */
+	if (is_caller_secure(flags))
+		SMC_RET1(handle, SMC_BATCH_E_DENIED);
+
+	if (GET_SMC_CC(smc_fid) != SMC_64)
+		SMC_RET1(handle, SMC_UNK);
+
+	switch (cmd) {
+	case SMC_BATCH_REGISTER:
+		rc = smc_batch_register(buf, x2, x3);
+		SMC_RET1(handle, rc);
+
+	case SMC_BATCH_RUN:
+		if (buf->size == 0U)
+			SMC_RET1(handle, SMC_BATCH_E_DENIED);
+
+		rc = smc_batch_run(buf, x2, x3, flags);
+		SMC_RET2(handle, rc, (rc == SMC_OK) ? x3 : 0U);
+
+	case SMC_BATCH_UNREGISTER:
+		spin_lock(&smc_batch_map_lock);
+		smc_batch_unmap(buf);
+		spin_unlock(&smc_batch_map_lock);
+		SMC_RET1(handle, SMC_OK);
+
+	default:
+		SMC_RET1(handle, SMC_UNK);
+	}
+}
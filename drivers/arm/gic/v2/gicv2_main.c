@@ -13,6 +13,7 @@
 #include <common/interrupt_props.h>
 #include <drivers/arm/gic_common.h>
 #include <drivers/arm/gicv2.h>
+#include <lib/lock_prof.h>
 #include <lib/spinlock.h>
 
 #include "../common/gic_common_private.h"
@@ -26,6 +27,7 @@ static const gicv2_driver_data_t *driver_data;
  * when the system is fully coherent.
  */
 static spinlock_t gic_lock;
+REGISTER_LOCK_PROF_LOCK(gic_lock);
 
 /*******************************************************************************
  * Enable secure interrupts and use FIQs to route them. Disable legacy bypass
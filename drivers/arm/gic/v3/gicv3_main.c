@@ -11,6 +11,7 @@
 #include <common/debug.h>
 #include <common/interrupt_props.h>
 #include <drivers/arm/gicv3.h>
+#include <lib/lock_prof.h>
 #include <lib/spinlock.h>
 
 #include "gicv3_private.h"
@@ -23,6 +24,7 @@ const gicv3_driver_data_t *gicv3_driver_data;
  * when the system is fully coherent.
  */
 static spinlock_t gic_lock;
+REGISTER_LOCK_PROF_LOCK(gic_lock);
 
 /*
  * Redistributor power operations are weakly bound so that they can be
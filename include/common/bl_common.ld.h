@@ -45,6 +45,18 @@
 	KEEP(*(pmf_svc_descs))				\
 	__PMF_SVC_DESCS_END__ = .;
 
+#define LOCK_PROF_DESCS					\
+	. = ALIGN(STRUCT_ALIGN);			\
+	__LOCK_PROF_DESCS_START__ = .;			\
+	KEEP(*(lock_prof_descs))			\
+	__LOCK_PROF_DESCS_END__ = .;
+
+#define PSCI_CMO_REGIONS				\
+	. = ALIGN(STRUCT_ALIGN);			\
+	__PSCI_CMO_REGIONS_START__ = .;			\
+	KEEP(*(psci_cmo_regions))			\
+	__PSCI_CMO_REGIONS_END__ = .;
+
 #define FCONF_POPULATOR					\
 	. = ALIGN(STRUCT_ALIGN);			\
 	__FCONF_POPULATOR_START__ = .;			\
@@ -84,6 +96,8 @@
 	RT_SVC_DESCS					\
 	FCONF_POPULATOR					\
 	PMF_SVC_DESCS					\
+	LOCK_PROF_DESCS					\
+	PSCI_CMO_REGIONS				\
 	PARSER_LIB_DESCS				\
 	CPU_OPS						\
 	GOT						\
@@ -41,6 +41,8 @@
 
 #ifndef __ASSEMBLER__
 
+#include <stdbool.h>
+
 /* Prototype for runtime service initializing function */
 typedef int32_t (*rt_svc_init_t)(void);
 
@@ -122,10 +124,108 @@ static inline uint32_t get_unique_oen_from_smc_fid(uint32_t fid)
 	return get_unique_oen(GET_SMC_OEN(fid), GET_SMC_TYPE(fid));
 }
 
+/*
+ * Second level dispatch of the SMCs routed to a runtime service. A service
+ * lists the function number ranges (FID[15:0]) it implements together with
+ * their calling conventions and handlers, and 'rt_svc_fid_table_init' turns
+ * the list into a two level table: FID[30] and FID[15:8] select a block of
+ * RT_SVC_FID_BLOCK_SIZE entries, which is indexed by FID[7:0] to get the index
+ * of the range. Only the blocks holding at least one function number are
+ * allocated, their number is fixed when the table is defined. Looking up a FID
+ * then takes the same two loads whatever its position in the list. Where
+ * ranges overlap the later one takes precedence, so that hot functions can be
+ * given handlers of their own.
+ */
+#define RT_SVC_FID_BLOCK_SHIFT	U(8)
+#define RT_SVC_FID_BLOCK_SIZE	(U(1) << RT_SVC_FID_BLOCK_SHIFT)
+#define RT_SVC_FID_BLOCKS	\
+	(((FUNCID_NUM_MASK >> RT_SVC_FID_BLOCK_SHIFT) + U(1)) << FUNCID_CC_WIDTH)
+#define RT_SVC_FID_NONE		U(0xff)
+
+/* Calling conventions of a range, both if none is given */
+#define RT_SVC_FID_CC_ANY	U(0)
+#define RT_SVC_FID_CC_SMC32	U(1)
+#define RT_SVC_FID_CC_SMC64	U(2)
+
+/* Key of a FID in the table, FID[30] followed by FID[15:0] */
+#define RT_SVC_FID_KEY(_cc, _fnum)	\
+	(((_cc) << FUNCID_NUM_WIDTH) | (_fnum))
+
+typedef struct rt_svc_fid_range {
+	uint16_t first;
+	uint16_t last;
+	uint8_t cc;
+	rt_svc_handle_t handle;
+} rt_svc_fid_range_t;
+
+typedef struct rt_svc_fid_table {
+	const rt_svc_fid_range_t *ranges;
+	uint8_t num_ranges;
+	uint8_t num_blocks;
+	uint8_t block_idx[RT_SVC_FID_BLOCKS];
+	uint8_t (*blocks)[RT_SVC_FID_BLOCK_SIZE];
+} rt_svc_fid_table_t;
+
+/*
+ * Range of the function numbers matching '_value' under '_mask', for both
+ * calling conventions
+ */
+#define RT_SVC_FID_MASKED_RANGE(_value, _mask, _handle)			\
+	{								\
+		.first = (_value),					\
+		.last = (_value) | (~(_mask) & FUNCID_NUM_MASK),	\
+		.cc = RT_SVC_FID_CC_ANY,				\
+		.handle = (_handle)					\
+	}
+
+/* The function '_fid' only, with the calling convention of '_fid' */
+#define RT_SVC_FID(_fid, _handle)					\
+	{								\
+		.first = GET_SMC_NUM(_fid),				\
+		.last = GET_SMC_NUM(_fid),				\
+		.cc = (GET_SMC_CC(_fid) == SMC_64) ?			\
+			RT_SVC_FID_CC_SMC64 : RT_SVC_FID_CC_SMC32,	\
+		.handle = (_handle)					\
+	}
+
+#define DEFINE_RT_SVC_FID_TABLE(_name, _ranges, _num_blocks)		\
+	static uint8_t _name ## _blocks[_num_blocks][RT_SVC_FID_BLOCK_SIZE]; \
+	static rt_svc_fid_table_t _name = {				\
+		.ranges = (_ranges),					\
+		.num_ranges = ARRAY_SIZE(_ranges),			\
+		.num_blocks = (_num_blocks),				\
+		.blocks = _name ## _blocks				\
+	}
+
+/*
+ * Return the handler of 'smc_fid' in 'table', NULL if there is none.
+ */
+static inline rt_svc_handle_t rt_svc_fid_lookup(const rt_svc_fid_table_t *table,
+						uint32_t smc_fid)
+{
+	uint32_t key = RT_SVC_FID_KEY(GET_SMC_CC(smc_fid),
+				      GET_SMC_NUM(smc_fid));
+	uint8_t idx;
+
+	idx = table->block_idx[key >> RT_SVC_FID_BLOCK_SHIFT];
+	if (idx == RT_SVC_FID_NONE)
+		return NULL;
+
+	idx = table->blocks[idx][key & (RT_SVC_FID_BLOCK_SIZE - U(1))];
+	if (idx == RT_SVC_FID_NONE)
+		return NULL;
+
+	return table->ranges[idx].handle;
+}
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
 void runtime_svc_init(void);
+int rt_svc_fid_table_init(rt_svc_fid_table_t *table);
+#if SMC_LIGHT_ENTRY
+bool rt_svc_is_light_smc(uint32_t smc_fid);
+#endif
 uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_START__,		RT_SVC_DESCS_START);
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef RUNTIME_SVC_ACCT_H
+#define RUNTIME_SVC_ACCT_H
+
+#include <lib/utils_def.h>
+
+/*
+ * SiP function ID for reading the SMC accounting data. The command is passed
+ * in x1, the arguments in x2-x4.
+ */
+#define SMC_ACCT_SMC_32			U(0x82000040)
+#define SMC_ACCT_SMC_64			U(0xC2000040)
+#define SMC_ACCT_FID_VALUE		U(0x40)
+#define is_smc_acct_fid(_fid)		\
+	(((_fid) & FUNCID_NUM_MASK) == SMC_ACCT_FID_VALUE)
+
+/*
+ * SMC_ACCT_INFO: x2 = MPIDR
+ *	returns x1 = number of FID slots, x2 = number of histogram buckets,
+ *		x3 = calls that found no free FID slot, x4 = counter frequency
+ * SMC_ACCT_OEN: x2 = MPIDR, x3 = unique OEN (OEN | call type << 6)
+ *	returns x1 = number of calls
+ * SMC_ACCT_FID: x2 = MPIDR, x3 = FID slot, x4 = first histogram bucket
+ *	returns x1 = FID, x2 = number of calls, x3 = total ticks,
+ *		x4-x7 = histogram buckets starting at x4
+ */
+#define SMC_ACCT_INFO			U(0)
+#define SMC_ACCT_OEN			U(1)
+#define SMC_ACCT_FID			U(2)
+
+#define SMC_ACCT_BUCKETS_PER_CALL	U(4)
+
+/*
+ * Bucket n of a latency histogram counts calls which took [2^n, 2^(n+1))
+ * ticks of the system counter, the last bucket also counts the longer ones.
+ */
+#define SMC_ACCT_HIST_BUCKETS		U(16)
+
+/*
+ * SMCs routed on their immediate rather than their FID (the KVM traps
+ * forwarded to the TITANIUM dispatcher) are accounted under this key. Bits
+ * [23:16] of a valid FID are zero so it cannot clash with one.
+ */
+#define SMC_ACCT_IMM_KEY(_imm)		(U(0xffff0000) | (_imm))
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#include <common/runtime_svc.h>
+#include <lib/cassert.h>
+
+#include <platform_def.h>
+
+CASSERT((SMC_ACCOUNTING_FIDS & (SMC_ACCOUNTING_FIDS - 1)) == 0,
+	assert_smc_accounting_fids_not_power_of_2);
+
+/* A slot is free as long as its count is 0 */
+typedef struct smc_acct_fid {
+	uint32_t fid;
+	uint64_t count;
+	uint64_t ticks;
+	uint32_t hist[SMC_ACCT_HIST_BUCKETS];
+} smc_acct_fid_t;
+
+typedef struct smc_acct_cpu {
+	uint64_t oen_count[MAX_RT_SVCS];
+	uint64_t untracked;
+	smc_acct_fid_t fids[SMC_ACCOUNTING_FIDS];
+} __aligned(CACHE_WRITEBACK_GRANULE) smc_acct_cpu_t;
+
+/* Exposed as is through debugfs */
+extern smc_acct_cpu_t smc_acct_stats[PLATFORM_CORE_COUNT];
+
+void smc_acct_record(uint32_t smc_fid, uint32_t imm, uint32_t oen_idx,
+		     uint64_t start);
+uintptr_t smc_acct_smc_handler(unsigned int smc_fid,
+			       u_register_t cmd,
+			       u_register_t x2,
+			       u_register_t x3,
+			       u_register_t x4,
+			       void *cookie,
+			       void *handle,
+			       u_register_t flags);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* RUNTIME_SVC_ACCT_H */
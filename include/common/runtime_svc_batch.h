@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef RUNTIME_SVC_BATCH_H
+#define RUNTIME_SVC_BATCH_H
+
+#include <lib/utils_def.h>
+
+/*
+ * SiP function ID for issuing a batch of SMCs in a single EL3 entry. The
+ * command is passed in x1, the arguments in x2-x4.
+ */
+#define SMC_BATCH_SMC_64		U(0xC2000041)
+#define SMC_BATCH_FID_VALUE		U(0x41)
+#define is_smc_batch_fid(_fid)		\
+	(((_fid) & FUNCID_NUM_MASK) == SMC_BATCH_FID_VALUE)
+
+/*
+ * SMC_BATCH_REGISTER: x2 = physical address of the buffer, x3 = its size
+ *	Maps the buffer of the calling cpu, replacing the one it had. Both
+ *	arguments must be page aligned and the size at most
+ *	SMC_BATCH_MAX_BUF_SIZE.
+ * SMC_BATCH_RUN: x2 = index of the first entry, x3 = number of entries
+ *	Issues the SMCs of the entries in order and stores their results.
+ *	returns x1 = number of entries run
+ * SMC_BATCH_UNREGISTER: unmaps the buffer of the calling cpu.
+ */
+#define SMC_BATCH_REGISTER		U(0)
+#define SMC_BATCH_RUN			U(1)
+#define SMC_BATCH_UNREGISTER		U(2)
+
+#define SMC_BATCH_MAX_BUF_SIZE		U(0x4000)
+
+#define SMC_BATCH_E_INVALID_PARAMS	-2
+#define SMC_BATCH_E_DENIED		-3
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#include <common/runtime_svc.h>
+
+/*
+ * One SMC of a batch. 'args' holds x0 (the FID) to x7 as the SMC is to be
+ * issued with, 'res' receives x0-x7 as the SMC returns them. SMCs which may
+ * not be batched return SMC_UNK in res[0].
+ */
+typedef struct smc_batch_entry {
+	uint64_t args[8];
+	uint64_t res[8];
+} smc_batch_entry_t;
+
+uintptr_t smc_batch_smc_handler(unsigned int smc_fid,
+				u_register_t cmd,
+				u_register_t x2,
+				u_register_t x3,
+				u_register_t x4,
+				void *cookie,
+				void *handle,
+				u_register_t flags);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* RUNTIME_SVC_BATCH_H */
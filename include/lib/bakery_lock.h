@@ -78,6 +78,24 @@ typedef struct bakery_lock {
  * the remaining cache lines are allocated by the linker script
  */
 
+#if QUEUED_LOCKS
+/*
+ * With QUEUED_LOCKS the per-CPU data of a lock is the node of that CPU in the
+ * MCS queue of the lock. CPU positions are stored plus one, so that 0 means
+ * none.
+ */
+typedef struct bakery_info {
+	/*
+	 * Last CPU queued, i.e. the owner if no CPU waits. Only used in the
+	 * data of CPU 0, which is the address of the lock.
+	 */
+	volatile uint32_t tail;
+	/* CPU queued after this one */
+	volatile uint16_t next;
+	/* Set while this CPU waits for the CPU queued before it */
+	volatile uint16_t wait;
+} bakery_info_t;
+#else
 typedef struct bakery_info {
 	/*
 	 * The lock_data is a bit-field of 2 members:
@@ -87,6 +105,7 @@ typedef struct bakery_info {
 	 */
 	volatile uint16_t lock_data;
 } bakery_info_t;
+#endif
 
 typedef bakery_info_t bakery_lock_t;
 
@@ -96,6 +115,22 @@ static inline void bakery_lock_init(bakery_lock_t *bakery) {}
 void bakery_lock_get(bakery_lock_t *bakery);
 void bakery_lock_release(bakery_lock_t *bakery);
 
+#if LOCK_PROFILING
+/* Whether any CPU holds or waits for the lock, for the lock profiler */
+bool bakery_lock_is_busy(bakery_lock_t *bakery);
+#endif
+
+#if LOCK_PROFILING && defined(IMAGE_BL31)
+/* Route the callers through the profiler, see lib/locks/lock_prof.c */
+void lock_prof_bakery_lock_get(bakery_lock_t *bakery);
+void lock_prof_bakery_lock_release(bakery_lock_t *bakery);
+
+#ifndef LOCK_PROF_NO_WRAPPERS
+#define bakery_lock_get(_bakery)	lock_prof_bakery_lock_get(_bakery)
+#define bakery_lock_release(_bakery)	lock_prof_bakery_lock_release(_bakery)
+#endif
+#endif
+
 #define DEFINE_BAKERY_LOCK(_name) bakery_lock_t _name __section("bakery_lock")
 
 #define DECLARE_BAKERY_LOCK(_name) extern bakery_lock_t _name
@@ -63,13 +63,26 @@
 #define CTX_IS_IN_EL3		U(0x30)
 #define CTX_EL3STATE_END	U(0x40) /* Align to the next 16 byte boundary */
 
+/*******************************************************************************
+ * Titanium: el2_sysregs_ctx. Its offsets, its register groups and the sequences
+ * saving and restoring them are generated from the register table of
+ * tools/ctx_layout/ctx_layout.py into context_el2.h. The block directly follows
+ * the EL3 state at a 64 byte boundary, so that a world switch touches the
+ * general purpose registers, the EL3 state and the EL2 registers as one
+ * contiguous range and the host-only registers share a single cache line of a
+ * cache line aligned context.
+ ******************************************************************************/
+#include <context_el2.h>
+
+#define CTX_EL2_SYSREGS_OFFSET	(CTX_EL3STATE_OFFSET + CTX_EL3STATE_END)
+
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the
  * 'el1_sys_regs' structure at their correct offsets. Note that some of the
  * registers are only 32-bits wide but are stored as 64-bit values for
  * convenience
  ******************************************************************************/
-#define CTX_EL1_SYSREGS_OFFSET	(CTX_EL3STATE_OFFSET + CTX_EL3STATE_END)
+#define CTX_EL1_SYSREGS_OFFSET	(CTX_EL2_SYSREGS_OFFSET + CTX_EL2_SYSREGS_END)
 #define CTX_SPSR_EL1		U(0x0)
 #define CTX_ELR_EL1		U(0x8)
 #define CTX_SCTLR_EL1		U(0x10)
@@ -141,49 +154,6 @@
  */
 #define CTX_EL1_SYSREGS_END		CTX_MTE_REGS_END
 
-// Titanium sel2 register
-#define CTX_EL1SRE_OFFSET	(CTX_CVE_2018_3639_OFFSET + CTX_CVE_2018_3639_END)
-#define CTX_EL1SRE_END		U(0x10) /* Align to the next 16 byte boundary */
-/*******************************************************************************
- * Titanium: el2_sysregs_ctx
- ******************************************************************************/
-#define CTX_EL2_SYSREGS_OFFSET	(CTX_EL1SRE_OFFSET + CTX_EL1SRE_END)
-#define CTX_SPSR_EL2		U(0x0)
-#define CTX_ELR_EL2		    U(0x8)
-#define CTX_SCTLR_EL2		U(0x10)
-#define CTX_ACTLR_EL2		U(0x18)
-#define CTX_VSTTBR_EL2		U(0x20)
-#define CTX_VSTCR_EL2		U(0x28)
-#define CTX_VTTBR_EL2		U(0x30)
-#define CTX_VTCR_EL2		U(0x38)
-#define CTX_SP_EL2		    U(0x40)
-#define CTX_ESR_EL2		    U(0x48)
-#define CTX_TTBR0_EL2		U(0x50)
-#define CTX_TTBR1_EL2		U(0x58)
-#define CTX_MAIR_EL2		U(0x60)
-#define CTX_AMAIR_EL2		U(0x68)
-#define CTX_TCR_EL2		    U(0x70)
-#define CTX_TPIDR_SEL0		U(0x78)
-#define CTX_TPIDR_SEL1		U(0x80)
-#define CTX_TPIDR_EL2		U(0x88)
-#define CTX_PAR_SEL1	   	U(0x90)
-#define CTX_HPFAR_EL2	   	U(0x98)
-#define CTX_FAR_EL2		    U(0xa0)
-#define CTX_AFSR0_EL2		U(0xa8)
-#define CTX_AFSR1_EL2		U(0xb0)
-#define CTX_CONTEXTIDR_EL2	U(0xb8)
-#define CTX_VBAR_EL2		U(0xc0)
-#define CTX_HCR_EL2         U(0xc8)
-#define CTX_CNTHCTL_EL2		U(0xd0)
-#define CTX_CNTHP_CTL_EL2         U(0xd8)
-#define CTX_CNTHP_CVAL_EL2         U(0xe0)
-#define CTX_CNTHP_TVAL_EL2         U(0xe8)
-#define CTX_CNTHV_CTL_EL2         U(0xf0)
-#define CTX_CNTHV_CVAL_EL2         U(0xf8)
-#define CTX_CNTHV_TVAL_EL2         U(0x100)
-#define CTX_EL2_SYSREGS_END U(0x110)
-
-
 /*
  * EL2 register set
  */
@@ -355,6 +325,20 @@
 #define CTX_PAUTH_REGS_END	U(0)
 #endif /* CTX_INCLUDE_PAUTH_REGS */
 
+/*******************************************************************************
+ * System register writes queued with cm_defer_sysreg_write() and performed by
+ * el3_exit once SCR_EL3 has been programmed. 'CTX_DEFER_PENDING' holds one bit
+ * per register ID and is cleared on exit; the values follow it, indexed by ID.
+ ******************************************************************************/
+#define CTX_DEFER_SYSREGS_OFFSET	(CTX_PAUTH_REGS_OFFSET + CTX_PAUTH_REGS_END)
+#define CTX_DEFER_PENDING		U(0x0)
+#define CTX_DEFER_VALUES		U(0x8)
+
+#define CTX_DEFER_ICC_SRE_EL1		U(0)
+#define CTX_DEFER_SYSREG_COUNT		U(1)
+
+#define CTX_DEFER_SYSREGS_END		U(0x10) /* Align to the next 16 byte boundary */
+
 #ifndef __ASSEMBLER__
 
 #include <stdint.h>
@@ -374,6 +358,7 @@
 /* Constants to determine the size of individual context structures */
 #define CTX_GPREG_ALL		(CTX_GPREGS_END >> DWORD_SHIFT)
 #define CTX_EL1_SYSREGS_ALL	(CTX_EL1_SYSREGS_END >> DWORD_SHIFT)
+#define CTX_EL2_SYS_REGS_ALL	(CTX_EL2_SYSREGS_END >> DWORD_SHIFT)
 #if CTX_INCLUDE_EL2_REGS
 # define CTX_EL2_SYSREGS_ALL	(CTX_EL2_SYSREGS_END >> DWORD_SHIFT)
 #endif
@@ -385,6 +370,7 @@
 #if CTX_INCLUDE_PAUTH_REGS
 # define CTX_PAUTH_REGS_ALL	(CTX_PAUTH_REGS_END >> DWORD_SHIFT)
 #endif
+#define CTX_DEFER_SYSREGS_ALL	(CTX_DEFER_SYSREGS_END >> DWORD_SHIFT)
 
 /*
  * AArch64 general purpose register context structure. Usually x0-x18,
@@ -401,8 +387,9 @@ DEFINE_REG_STRUCT(gp_regs, CTX_GPREG_ALL);
  */
 DEFINE_REG_STRUCT(el1_sysregs, CTX_EL1_SYSREGS_ALL);
 
+/* Titanium EL2 system register context structure, see context_el2.h */
+DEFINE_REG_STRUCT(el2_sys_regs, CTX_EL2_SYS_REGS_ALL);
 
-DEFINE_REG_STRUCT(el2_sys_regs, CTX_EL1_SYSREGS_ALL);
 /*
  * AArch64 EL2 system register context structure for preserving the
  * architectural state during world switches.
@@ -434,6 +421,9 @@ DEFINE_REG_STRUCT(cve_2018_3639, CTX_CVE_2018_3639_ALL);
 DEFINE_REG_STRUCT(pauth, CTX_PAUTH_REGS_ALL);
 #endif
 
+/* Pending bitmap and values of the deferred system register writes */
+DEFINE_REG_STRUCT(defer_sysregs, CTX_DEFER_SYSREGS_ALL);
+
 /*
  * Macros to access members of any of the above structures using their
  * offsets
@@ -454,6 +444,7 @@ DEFINE_REG_STRUCT(pauth, CTX_PAUTH_REGS_ALL);
 typedef struct cpu_context {
 	gp_regs_t gpregs_ctx;
 	el3_state_t el3state_ctx;
+	el2_sys_regs_t el2_sysregs_ctx;
 	el1_sysregs_t el1_sysregs_ctx;
 #if CTX_INCLUDE_EL2_REGS
 	el2_sysregs_t el2_sysregs_ctx;
@@ -465,8 +456,7 @@ typedef struct cpu_context {
 #if CTX_INCLUDE_PAUTH_REGS
 	pauth_t pauth_ctx;
 #endif
-	uint64_t icc_sre_el1;
-	el2_sys_regs_t el2_sysregs_ctx;
+	defer_sysregs_t defer_sysregs_ctx;
 } cpu_context_t;
 
 /* Macros to access members of the 'cpu_context_t' structure */
@@ -480,6 +470,7 @@ typedef struct cpu_context {
 # define get_el2_sysregs_ctx(h)	(&((cpu_context_t *) h)->el2_sysregs_ctx)
 #endif
 #define get_gpregs_ctx(h)	(&((cpu_context_t *) h)->gpregs_ctx)
+#define get_defer_sysregs_ctx(h)	(&((cpu_context_t *) h)->defer_sysregs_ctx)
 #define get_cve_2018_3639_ctx(h)	(&((cpu_context_t *) h)->cve_2018_3639_ctx)
 #if CTX_INCLUDE_PAUTH_REGS
 # define get_pauth_ctx(h)	(&((cpu_context_t *) h)->pauth_ctx)
@@ -496,6 +487,8 @@ CASSERT(CTX_EL1_SYSREGS_OFFSET == __builtin_offsetof(cpu_context_t, el1_sysregs_
 	assert_core_context_el1_sys_offset_mismatch);
 CASSERT(CTX_EL2_SYSREGS_OFFSET == __builtin_offsetof(cpu_context_t, el2_sysregs_ctx), \
 	assert_core_el2_context_sys_offset_mismatch);
+CASSERT((CTX_EL2_SYSREGS_OFFSET & U(0x3f)) == 0U, \
+	assert_core_el2_context_sys_not_line_aligned);
 #if CTX_INCLUDE_EL2_REGS
 CASSERT(CTX_EL2_SYSREGS_OFFSET == __builtin_offsetof(cpu_context_t, el2_sysregs_ctx), \
 	assert_core_context_el2_sys_offset_mismatch);
@@ -512,6 +505,10 @@ CASSERT(CTX_CVE_2018_3639_OFFSET == __builtin_offsetof(cpu_context_t, cve_2018_3
 CASSERT(CTX_PAUTH_REGS_OFFSET == __builtin_offsetof(cpu_context_t, pauth_ctx), \
 	assert_core_context_pauth_offset_mismatch);
 #endif
+CASSERT(CTX_DEFER_SYSREGS_OFFSET == __builtin_offsetof(cpu_context_t, defer_sysregs_ctx), \
+	assert_core_context_defer_sysregs_offset_mismatch);
+CASSERT(CTX_DEFER_VALUES + (CTX_DEFER_SYSREG_COUNT << DWORD_SHIFT) <= \
+	CTX_DEFER_SYSREGS_END, assert_core_context_defer_sysregs_too_small);
 
 /*
  * Helper macro to set the general purpose registers that correspond to
@@ -559,6 +556,14 @@ void el2_sysregs_context_save(el2_sys_regs_t *regs);
 void el2_sysregs_context_restore(el2_sys_regs_t *regs);
 void el2_sysregs_context_save_host_only(el2_sys_regs_t *regs);
 void el2_sysregs_context_restore_host_only(el2_sys_regs_t *regs);
+void el2_sysregs_trans_save(el2_sys_regs_t *regs);
+void el2_sysregs_trans_restore(el2_sys_regs_t *regs);
+void el2_sysregs_except_save(el2_sys_regs_t *regs);
+void el2_sysregs_except_restore(el2_sys_regs_t *regs);
+void el2_sysregs_thread_save(el2_sys_regs_t *regs);
+void el2_sysregs_thread_restore(el2_sys_regs_t *regs);
+void el2_sysregs_timer_save(el2_sys_regs_t *regs);
+void el2_sysregs_timer_restore(el2_sys_regs_t *regs);
 #if CTX_INCLUDE_EL2_REGS
 void el2_sysregs_context_save(el2_sysregs_t *regs);
 void el2_sysregs_context_restore(el2_sysregs_t *regs);
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Generated by tools/ctx_layout/ctx_layout.py from the 'titanium' layout,
+ * do not edit.
+ */
+
+#ifndef CONTEXT_EL2_H
+#define CONTEXT_EL2_H
+
+#include <lib/utils_def.h>
+
+/* Offsets in the 'el2_sys_regs' block */
+#define CTX_TTBR0_EL2           U(0x0)
+#define CTX_TCR_EL2             U(0x8)
+#define CTX_SP_EL2              U(0x10)
+#define CTX_VBAR_EL2            U(0x18)
+#define CTX_TPIDR_EL2           U(0x20)
+#define CTX_SCTLR_EL2           U(0x28)
+#define CTX_ACTLR_EL2           U(0x30)
+#define CTX_VSTTBR_EL2          U(0x38)
+#define CTX_VSTCR_EL2           U(0x40)
+#define CTX_VTTBR_EL2           U(0x48)
+#define CTX_VTCR_EL2            U(0x50)
+#define CTX_MAIR_EL2            U(0x58)
+#define CTX_AMAIR_EL2           U(0x60)
+#define CTX_HCR_EL2             U(0x68)
+#define CTX_SPSR_EL2            U(0x70)
+#define CTX_ELR_EL2             U(0x78)
+#define CTX_ESR_EL2             U(0x80)
+#define CTX_HPFAR_EL2           U(0x88)
+#define CTX_FAR_EL2             U(0x90)
+#define CTX_AFSR0_EL2           U(0x98)
+#define CTX_AFSR1_EL2           U(0xa0)
+#define CTX_TPIDR_SEL0          U(0xa8)
+#define CTX_TPIDR_SEL1          U(0xb0)
+#define CTX_PAR_SEL1            U(0xb8)
+#define CTX_CONTEXTIDR_EL2      U(0xc0)
+#define CTX_CNTHCTL_EL2         U(0xc8)
+#define CTX_CNTHP_CTL_EL2       U(0xd0)
+#define CTX_CNTHP_CVAL_EL2      U(0xd8)
+#define CTX_CNTHP_TVAL_EL2      U(0xe0)
+#define CTX_CNTHV_CTL_EL2       U(0xe8)
+#define CTX_CNTHV_CVAL_EL2      U(0xf0)
+#define CTX_CNTHV_TVAL_EL2      U(0xf8)
+#define CTX_EL2_SYSREGS_END     U(0x100)
+
+/* Register groups, each saved and restored as a unit */
+#define CTX_EL2_GRP_TRANS       U(0)
+#define CTX_EL2_GRP_EXCEPT      U(1)
+#define CTX_EL2_GRP_THREAD      U(2)
+#define CTX_EL2_GRP_TIMER       U(3)
+#define CTX_EL2_GRP_COUNT       U(4)
+
+#define CTX_EL2_GRP_BIT(grp)	(U(1) << (grp))
+#define CTX_EL2_GRPS_ALL	((U(1) << CTX_EL2_GRP_COUNT) - U(1))
+
+/* Groups touched by the host-only save and restore */
+#define CTX_EL2_GRPS_HOST_ONLY	(CTX_EL2_GRP_BIT(CTX_EL2_GRP_TRANS) | \
+				 CTX_EL2_GRP_BIT(CTX_EL2_GRP_EXCEPT) | \
+				 CTX_EL2_GRP_BIT(CTX_EL2_GRP_THREAD))
+
+/* Context offsets of the registers of every group */
+#define CTX_EL2_GRP_TRANS_REGS	\
+	CTX_TTBR0_EL2, CTX_TCR_EL2, CTX_SCTLR_EL2, CTX_ACTLR_EL2,	\
+	CTX_VSTTBR_EL2, CTX_VSTCR_EL2, CTX_VTTBR_EL2, CTX_VTCR_EL2,	\
+	CTX_MAIR_EL2, CTX_AMAIR_EL2, CTX_HCR_EL2
+#define CTX_EL2_GRP_EXCEPT_REGS	\
+	CTX_SP_EL2, CTX_VBAR_EL2, CTX_SPSR_EL2, CTX_ELR_EL2, CTX_ESR_EL2,	\
+	CTX_HPFAR_EL2, CTX_FAR_EL2, CTX_AFSR0_EL2, CTX_AFSR1_EL2
+#define CTX_EL2_GRP_THREAD_REGS	\
+	CTX_TPIDR_EL2, CTX_TPIDR_SEL0, CTX_TPIDR_SEL1, CTX_PAR_SEL1,	\
+	CTX_CONTEXTIDR_EL2
+#define CTX_EL2_GRP_TIMER_REGS	\
+	CTX_CNTHCTL_EL2, CTX_CNTHP_CTL_EL2, CTX_CNTHP_CVAL_EL2,	\
+	CTX_CNTHP_TVAL_EL2, CTX_CNTHV_CTL_EL2, CTX_CNTHV_CVAL_EL2,	\
+	CTX_CNTHV_TVAL_EL2
+#define CTX_EL2_HOST_ONLY_REGS	\
+	CTX_TTBR0_EL2, CTX_TCR_EL2, CTX_SP_EL2, CTX_VBAR_EL2, CTX_TPIDR_EL2
+#define CTX_EL2_HOST_ONLY_COUNT U(5)
+
+#ifdef __ASSEMBLER__
+
+/*
+ * Save or restore registers of the 'el2_sys_regs' block at 'base', only
+ * using x9-x17 as scratch.
+ */
+	.macro	el2_sysregs_all_save_regs base
+	mrs	x9, ttbr0_el2
+	mrs	x10, tcr_el2
+	stp	x9, x10, [\base, #CTX_TTBR0_EL2]
+	mrs	x11, sp_el2
+	mrs	x12, vbar_el2
+	stp	x11, x12, [\base, #CTX_SP_EL2]
+	mrs	x13, tpidr_el2
+	mrs	x14, sctlr_el2
+	stp	x13, x14, [\base, #CTX_TPIDR_EL2]
+	mrs	x15, actlr_el2
+	mrs	x16, vsttbr_el2
+	stp	x15, x16, [\base, #CTX_ACTLR_EL2]
+	mrs	x17, vstcr_el2
+	mrs	x9, vttbr_el2
+	stp	x17, x9, [\base, #CTX_VSTCR_EL2]
+	mrs	x10, vtcr_el2
+	mrs	x11, mair_el2
+	stp	x10, x11, [\base, #CTX_VTCR_EL2]
+	mrs	x12, amair_el2
+	mrs	x13, hcr_el2
+	stp	x12, x13, [\base, #CTX_AMAIR_EL2]
+	mrs	x14, spsr_el2
+	mrs	x15, elr_el2
+	stp	x14, x15, [\base, #CTX_SPSR_EL2]
+	mrs	x16, esr_el2
+	mrs	x17, hpfar_el2
+	stp	x16, x17, [\base, #CTX_ESR_EL2]
+	mrs	x9, far_el2
+	mrs	x10, afsr0_el2
+	stp	x9, x10, [\base, #CTX_FAR_EL2]
+	mrs	x11, afsr1_el2
+	mrs	x12, tpidr_el0
+	stp	x11, x12, [\base, #CTX_AFSR1_EL2]
+	mrs	x13, tpidr_el1
+	mrs	x14, par_el1
+	stp	x13, x14, [\base, #CTX_TPIDR_SEL1]
+	mrs	x15, contextidr_el2
+	mrs	x16, cnthctl_el2
+	stp	x15, x16, [\base, #CTX_CONTEXTIDR_EL2]
+	mrs	x17, cnthp_ctl_el2
+	mrs	x9, cnthp_cval_el2
+	stp	x17, x9, [\base, #CTX_CNTHP_CTL_EL2]
+	mrs	x10, cnthp_tval_el2
+	mrs	x11, cnthv_ctl_el2
+	stp	x10, x11, [\base, #CTX_CNTHP_TVAL_EL2]
+	mrs	x12, cnthv_cval_el2
+	mrs	x13, cnthv_tval_el2
+	stp	x12, x13, [\base, #CTX_CNTHV_CVAL_EL2]
+	.endm
+
+	.macro	el2_sysregs_all_restore_regs base
+	ldp	x9, x10, [\base, #CTX_TTBR0_EL2]
+	msr	ttbr0_el2, x9
+	msr	tcr_el2, x10
+	ldp	x11, x12, [\base, #CTX_SP_EL2]
+	msr	sp_el2, x11
+	msr	vbar_el2, x12
+	ldp	x13, x14, [\base, #CTX_TPIDR_EL2]
+	msr	tpidr_el2, x13
+	msr	sctlr_el2, x14
+	ldp	x15, x16, [\base, #CTX_ACTLR_EL2]
+	msr	actlr_el2, x15
+	msr	vsttbr_el2, x16
+	ldp	x17, x9, [\base, #CTX_VSTCR_EL2]
+	msr	vstcr_el2, x17
+	msr	vttbr_el2, x9
+	ldp	x10, x11, [\base, #CTX_VTCR_EL2]
+	msr	vtcr_el2, x10
+	msr	mair_el2, x11
+	ldp	x12, x13, [\base, #CTX_AMAIR_EL2]
+	msr	amair_el2, x12
+	msr	hcr_el2, x13
+	ldp	x14, x15, [\base, #CTX_SPSR_EL2]
+	msr	spsr_el2, x14
+	msr	elr_el2, x15
+	ldp	x16, x17, [\base, #CTX_ESR_EL2]
+	msr	esr_el2, x16
+	msr	hpfar_el2, x17
+	ldp	x9, x10, [\base, #CTX_FAR_EL2]
+	msr	far_el2, x9
+	msr	afsr0_el2, x10
+	ldp	x11, x12, [\base, #CTX_AFSR1_EL2]
+	msr	afsr1_el2, x11
+	msr	tpidr_el0, x12
+	ldp	x13, x14, [\base, #CTX_TPIDR_SEL1]
+	msr	tpidr_el1, x13
+	msr	par_el1, x14
+	ldp	x15, x16, [\base, #CTX_CONTEXTIDR_EL2]
+	msr	contextidr_el2, x15
+	msr	cnthctl_el2, x16
+	ldp	x17, x9, [\base, #CTX_CNTHP_CTL_EL2]
+	msr	cnthp_ctl_el2, x17
+	msr	cnthp_cval_el2, x9
+	ldp	x10, x11, [\base, #CTX_CNTHP_TVAL_EL2]
+	msr	cnthp_tval_el2, x10
+	msr	cnthv_ctl_el2, x11
+	ldp	x12, x13, [\base, #CTX_CNTHV_CVAL_EL2]
+	msr	cnthv_cval_el2, x12
+	msr	cnthv_tval_el2, x13
+	.endm
+
+	.macro	el2_sysregs_trans_save_regs base
+	mrs	x9, ttbr0_el2
+	mrs	x10, tcr_el2
+	stp	x9, x10, [\base, #CTX_TTBR0_EL2]
+	mrs	x11, sctlr_el2
+	mrs	x12, actlr_el2
+	stp	x11, x12, [\base, #CTX_SCTLR_EL2]
+	mrs	x13, vsttbr_el2
+	mrs	x14, vstcr_el2
+	stp	x13, x14, [\base, #CTX_VSTTBR_EL2]
+	mrs	x15, vttbr_el2
+	mrs	x16, vtcr_el2
+	stp	x15, x16, [\base, #CTX_VTTBR_EL2]
+	mrs	x17, mair_el2
+	mrs	x9, amair_el2
+	stp	x17, x9, [\base, #CTX_MAIR_EL2]
+	mrs	x10, hcr_el2
+	str	x10, [\base, #CTX_HCR_EL2]
+	.endm
+
+	.macro	el2_sysregs_trans_restore_regs base
+	ldp	x9, x10, [\base, #CTX_TTBR0_EL2]
+	msr	ttbr0_el2, x9
+	msr	tcr_el2, x10
+	ldp	x11, x12, [\base, #CTX_SCTLR_EL2]
+	msr	sctlr_el2, x11
+	msr	actlr_el2, x12
+	ldp	x13, x14, [\base, #CTX_VSTTBR_EL2]
+	msr	vsttbr_el2, x13
+	msr	vstcr_el2, x14
+	ldp	x15, x16, [\base, #CTX_VTTBR_EL2]
+	msr	vttbr_el2, x15
+	msr	vtcr_el2, x16
+	ldp	x17, x9, [\base, #CTX_MAIR_EL2]
+	msr	mair_el2, x17
+	msr	amair_el2, x9
+	ldr	x10, [\base, #CTX_HCR_EL2]
+	msr	hcr_el2, x10
+	.endm
+
+	.macro	el2_sysregs_except_save_regs base
+	mrs	x9, sp_el2
+	mrs	x10, vbar_el2
+	stp	x9, x10, [\base, #CTX_SP_EL2]
+	mrs	x11, spsr_el2
+	mrs	x12, elr_el2
+	stp	x11, x12, [\base, #CTX_SPSR_EL2]
+	mrs	x13, esr_el2
+	mrs	x14, hpfar_el2
+	stp	x13, x14, [\base, #CTX_ESR_EL2]
+	mrs	x15, far_el2
+	mrs	x16, afsr0_el2
+	stp	x15, x16, [\base, #CTX_FAR_EL2]
+	mrs	x17, afsr1_el2
+	str	x17, [\base, #CTX_AFSR1_EL2]
+	.endm
+
+	.macro	el2_sysregs_except_restore_regs base
+	ldp	x9, x10, [\base, #CTX_SP_EL2]
+	msr	sp_el2, x9
+	msr	vbar_el2, x10
+	ldp	x11, x12, [\base, #CTX_SPSR_EL2]
+	msr	spsr_el2, x11
+	msr	elr_el2, x12
+	ldp	x13, x14, [\base, #CTX_ESR_EL2]
+	msr	esr_el2, x13
+	msr	hpfar_el2, x14
+	ldp	x15, x16, [\base, #CTX_FAR_EL2]
+	msr	far_el2, x15
+	msr	afsr0_el2, x16
+	ldr	x17, [\base, #CTX_AFSR1_EL2]
+	msr	afsr1_el2, x17
+	.endm
+
+	.macro	el2_sysregs_thread_save_regs base
+	mrs	x9, tpidr_el2
+	str	x9, [\base, #CTX_TPIDR_EL2]
+	mrs	x10, tpidr_el0
+	mrs	x11, tpidr_el1
+	stp	x10, x11, [\base, #CTX_TPIDR_SEL0]
+	mrs	x12, par_el1
+	mrs	x13, contextidr_el2
+	stp	x12, x13, [\base, #CTX_PAR_SEL1]
+	.endm
+
+	.macro	el2_sysregs_thread_restore_regs base
+	ldr	x9, [\base, #CTX_TPIDR_EL2]
+	msr	tpidr_el2, x9
+	ldp	x10, x11, [\base, #CTX_TPIDR_SEL0]
+	msr	tpidr_el0, x10
+	msr	tpidr_el1, x11
+	ldp	x12, x13, [\base, #CTX_PAR_SEL1]
+	msr	par_el1, x12
+	msr	contextidr_el2, x13
+	.endm
+
+	.macro	el2_sysregs_timer_save_regs base
+	mrs	x9, cnthctl_el2
+	mrs	x10, cnthp_ctl_el2
+	stp	x9, x10, [\base, #CTX_CNTHCTL_EL2]
+	mrs	x11, cnthp_cval_el2
+	mrs	x12, cnthp_tval_el2
+	stp	x11, x12, [\base, #CTX_CNTHP_CVAL_EL2]
+	mrs	x13, cnthv_ctl_el2
+	mrs	x14, cnthv_cval_el2
+	stp	x13, x14, [\base, #CTX_CNTHV_CTL_EL2]
+	mrs	x15, cnthv_tval_el2
+	str	x15, [\base, #CTX_CNTHV_TVAL_EL2]
+	.endm
+
+	.macro	el2_sysregs_timer_restore_regs base
+	ldp	x9, x10, [\base, #CTX_CNTHCTL_EL2]
+	msr	cnthctl_el2, x9
+	msr	cnthp_ctl_el2, x10
+	ldp	x11, x12, [\base, #CTX_CNTHP_CVAL_EL2]
+	msr	cnthp_cval_el2, x11
+	msr	cnthp_tval_el2, x12
+	ldp	x13, x14, [\base, #CTX_CNTHV_CTL_EL2]
+	msr	cnthv_ctl_el2, x13
+	msr	cnthv_cval_el2, x14
+	ldr	x15, [\base, #CTX_CNTHV_TVAL_EL2]
+	msr	cnthv_tval_el2, x15
+	.endm
+
+	.macro	el2_sysregs_host_only_save_regs base
+	mrs	x9, ttbr0_el2
+	mrs	x10, tcr_el2
+	stp	x9, x10, [\base, #CTX_TTBR0_EL2]
+	mrs	x11, sp_el2
+	mrs	x12, vbar_el2
+	stp	x11, x12, [\base, #CTX_SP_EL2]
+	mrs	x13, tpidr_el2
+	str	x13, [\base, #CTX_TPIDR_EL2]
+	.endm
+
+	.macro	el2_sysregs_host_only_restore_regs base
+	ldp	x9, x10, [\base, #CTX_TTBR0_EL2]
+	msr	ttbr0_el2, x9
+	msr	tcr_el2, x10
+	ldp	x11, x12, [\base, #CTX_SP_EL2]
+	msr	sp_el2, x11
+	msr	vbar_el2, x12
+	ldr	x13, [\base, #CTX_TPIDR_EL2]
+	msr	tpidr_el2, x13
+	.endm
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* CONTEXT_EL2_H */
@@ -34,6 +34,9 @@ void cm_init_context_by_index(unsigned int cpu_idx,
 			      const struct entry_point_info *ep);
 void cm_setup_context(cpu_context_t *ctx, const struct entry_point_info *ep);
 void cm_prepare_el3_exit(uint32_t security_state);
+#if WARMBOOT_GOLDEN_CTX
+void cm_invalidate_golden_ctx(void);
+#endif
 
 #ifdef __aarch64__
 #if CTX_INCLUDE_EL2_REGS
@@ -45,7 +48,12 @@ void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
 void cm_el2_sysregs_context_save(uint32_t security_state, uint32_t is_host_only);
 void cm_el2_sysregs_context_restore(uint32_t security_state, uint32_t is_host_only);
-void cm_set_sre_el1(uint32_t security_state, uint64_t sre_value);
+void cm_el2_sysregs_set_switched_grps(unsigned int grps);
+void cm_defer_sysreg_write(uint32_t security_state, unsigned int id,
+			   u_register_t value);
+#if CTX_INCLUDE_FPREGS
+void cm_fpregs_context_switch(uint32_t security_state);
+#endif
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
 uint64_t cm_get_elr_el3(uint32_t security_state);
 uint64_t cm_get_vbar_el2(uint32_t security_state);
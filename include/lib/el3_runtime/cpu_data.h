@@ -19,6 +19,9 @@
 /* 8-bytes aligned size of psci_cpu_data structure */
 #define PSCI_CPU_DATA_SIZE_ALIGNED	((PSCI_CPU_DATA_SIZE + 7) & ~7)
 
+/* Offset of cpu_context[2], size 16 bytes */
+#define CPU_DATA_CONTEXT_OFFSET		0x0
+
 /* Offset of cpu_ops_ptr, size 8 bytes */
 #define CPU_DATA_CPU_OPS_PTR		0x10
 
@@ -61,6 +64,20 @@
 #define CPU_DATA_PMF_TS_COUNT		1
 #define CPU_DATA_PMF_TS0_OFFSET		CPU_DATA_CRASH_BUF_END
 #define CPU_DATA_PMF_TS0_IDX		0
+#define CPU_DATA_PMF_TS_END		(CPU_DATA_PMF_TS0_OFFSET + \
+					 (CPU_DATA_PMF_TS_COUNT << 3))
+#else
+#define CPU_DATA_PMF_TS_END		CPU_DATA_CRASH_BUF_END
+#endif
+
+#if CTX_FPREGS_LAZY
+/*
+ * Security state whose FP/SIMD registers are loaded, plus one, or
+ * CPU_FP_OWNER_NONE if the registers do not hold any saved state
+ */
+#define CPU_DATA_FP_OWNER_OFFSET	CPU_DATA_PMF_TS_END
+#define CPU_FP_OWNER_NONE		0
+#define CPU_FP_OWNER(_state)		((_state) + 1)
 #endif
 
 #ifndef __ASSEMBLER__
@@ -112,6 +129,9 @@ typedef struct cpu_data {
 #if ENABLE_RUNTIME_INSTRUMENTATION
 	uint64_t cpu_data_pmf_ts[CPU_DATA_PMF_TS_COUNT];
 #endif
+#if CTX_FPREGS_LAZY
+	uint64_t cpu_fp_owner;
+#endif
 #if PLAT_PCPU_DATA_SIZE
 	uint8_t platform_cpu_data[PLAT_PCPU_DATA_SIZE];
 #endif
@@ -122,6 +142,12 @@ typedef struct cpu_data {
 
 extern cpu_data_t percpu_data[PLATFORM_CORE_COUNT];
 
+#ifdef __aarch64__
+CASSERT(CPU_DATA_CONTEXT_OFFSET == __builtin_offsetof
+	(cpu_data_t, cpu_context),
+	assert_cpu_data_context_offset_mismatch);
+#endif
+
 #if ENABLE_PAUTH
 CASSERT(CPU_DATA_APIAKEY_OFFSET == __builtin_offsetof
 	(cpu_data_t, apiakey),
@@ -148,6 +174,12 @@ CASSERT(CPU_DATA_PMF_TS0_OFFSET == __builtin_offsetof
 		assert_cpu_data_pmf_ts0_offset_mismatch);
 #endif
 
+#if CTX_FPREGS_LAZY
+CASSERT(CPU_DATA_FP_OWNER_OFFSET == __builtin_offsetof
+		(cpu_data_t, cpu_fp_owner),
+		assert_cpu_data_fp_owner_offset_mismatch);
+#endif
+
 struct cpu_data *_cpu_data_by_index(uint32_t cpu_index);
 
 #ifdef __aarch64__
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LOCK_PROF_H
+#define LOCK_PROF_H
+
+#include <lib/utils_def.h>
+
+/*
+ * SiP function ID for reading the lock profiling data. The command is passed
+ * in x1, the arguments in x2-x4. Outside of DEBUG builds, only the secure
+ * world may issue it.
+ */
+#define LOCK_PROF_SMC_32		U(0x82000042)
+#define LOCK_PROF_SMC_64		U(0xC2000042)
+#define LOCK_PROF_FID_VALUE		U(0x42)
+#define is_lock_prof_fid(_fid)		\
+	(((_fid) & FUNCID_NUM_MASK) == LOCK_PROF_FID_VALUE)
+
+/*
+ * LOCK_PROF_INFO:
+ *	returns x1 = number of profiled locks, x2 = counter frequency
+ * LOCK_PROF_LOCK: x2 = lock index
+ *	returns x1 = address of the lock, x2 = number of acquisitions,
+ *		x3 = contended acquisitions, x4 = total wait ticks,
+ *		x5 = longest wait, x6 = longest hold, in ticks
+ * LOCK_PROF_PCS: x2 = lock index
+ *	returns x1 = call site of the longest wait,
+ *		x2 = call site of the longest hold
+ * LOCK_PROF_RESET: clears the statistics of all locks.
+ */
+#define LOCK_PROF_INFO			U(0)
+#define LOCK_PROF_LOCK			U(1)
+#define LOCK_PROF_PCS			U(2)
+#define LOCK_PROF_RESET			U(3)
+
+#ifndef __ASSEMBLER__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <common/runtime_svc.h>
+#include <lib/cassert.h>
+
+/*
+ * Statistics of a lock, in ticks of the system counter. They are only updated
+ * by the owner of the lock, so they need no lock of their own.
+ */
+typedef struct lock_prof_stats {
+	uint64_t acquires;
+	uint64_t contended;
+	uint64_t wait_ticks;
+	uint64_t max_wait_ticks;
+	uint64_t max_hold_ticks;
+	uintptr_t max_wait_pc;
+	uintptr_t max_hold_pc;
+
+	/* Acquisition in progress, 0 when the lock is free */
+	uint64_t acquired_at;
+	uintptr_t acquired_pc;
+} lock_prof_stats_t;
+
+/* 'num' locks at 'base', 'stride' bytes apart */
+typedef struct lock_prof_desc {
+	const char *name;
+	uintptr_t base;
+	size_t stride;
+	unsigned int num;
+	lock_prof_stats_t *stats;
+} lock_prof_desc_t;
+
+#if LOCK_PROFILING && defined(IMAGE_BL31)
+/*
+ * Register the locks at '_base', which may be the first member of an array of
+ * '_num' structures of '_stride' bytes, for profiling.
+ */
+#define REGISTER_LOCK_PROF(_name, _base, _stride, _num)			\
+	static lock_prof_stats_t __lock_prof_stats_ ## _name[_num];	\
+	static const lock_prof_desc_t __lock_prof_desc_ ## _name	\
+	__section("lock_prof_descs") __used = {				\
+		.name = #_name,						\
+		.base = (uintptr_t)(_base),				\
+		.stride = (_stride),					\
+		.num = (_num),						\
+		.stats = __lock_prof_stats_ ## _name			\
+	}
+#else
+#define REGISTER_LOCK_PROF(_name, _base, _stride, _num)			\
+	CASSERT(1, __lock_prof_unused_ ## _name)
+#endif
+
+/* Convenience macros to register a single lock or an array of locks */
+#define REGISTER_LOCK_PROF_LOCK(_lock)					\
+	REGISTER_LOCK_PROF(_lock, &(_lock), sizeof(_lock), 1U)
+#define REGISTER_LOCK_PROF_ARRAY(_locks)				\
+	REGISTER_LOCK_PROF(_locks, &(_locks)[0], sizeof((_locks)[0]),	\
+			   ARRAY_SIZE(_locks))
+
+uintptr_t lock_prof_smc_handler(unsigned int smc_fid,
+				u_register_t cmd,
+				u_register_t x2,
+				u_register_t x3,
+				u_register_t x4,
+				void *cookie,
+				void *handle,
+				u_register_t flags);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* LOCK_PROF_H */
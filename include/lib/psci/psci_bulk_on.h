@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_BULK_ON_H
+#define PSCI_BULK_ON_H
+
+#include <lib/utils_def.h>
+
+/*
+ * SiP function ID for powering on several CPUs with one call, for the normal
+ * world to bring its secondary CPUs up with. As for CPU_ON, x1 is the entry
+ * point and x2 the context ID, which all CPUs share. x3 is an MPIDR whose Aff0
+ * field is 0, and bit n of x4 selects the CPU with that MPIDR and Aff0 n.
+ *
+ * Returns x0 = PSCI_E_SUCCESS, x1 = bitmap of the CPUs which are powering on,
+ * in the format of x4. A selected CPU which is missing from x1 was already ON
+ * or ON_PENDING, or the platform failed to power it on; CPU_ON tells which.
+ * Otherwise x0 is the error CPU_ON would return for invalid arguments, and no
+ * CPU has been powered on.
+ */
+#define PSCI_BULK_ON_SMC_32		U(0x82000045)
+#define PSCI_BULK_ON_SMC_64		U(0xC2000045)
+#define PSCI_BULK_ON_FID_VALUE		U(0x45)
+#define is_psci_bulk_on_fid(_fid)	\
+	(((_fid) & FUNCID_NUM_MASK) == PSCI_BULK_ON_FID_VALUE)
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#include <common/runtime_svc.h>
+
+uintptr_t psci_bulk_on_smc_handler(unsigned int smc_fid,
+				   u_register_t entrypoint,
+				   u_register_t context_id,
+				   u_register_t base_mpidr,
+				   u_register_t cpu_map,
+				   void *cookie,
+				   void *handle,
+				   u_register_t flags);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* PSCI_BULK_ON_H */
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_CMO_H
+#define PSCI_CMO_H
+
+#include <lib/utils_def.h>
+
+/*
+ * Value of the stride of a region whose per-CPU slices are contiguous and as
+ * large as the region itself.
+ */
+#define PSCI_CMO_STRIDE_SLICE		(~(size_t)0)
+
+#ifndef __ASSEMBLER__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/cassert.h>
+
+/*
+ * EL3 data which a CPU writes back to memory by VA before it powers down with
+ * PSCI_TARGETED_CMO. [base, end) is the region of CPU 0, and 'stride' the
+ * distance between the regions of consecutive CPUs, 0 when the region is
+ * shared by all CPUs.
+ */
+typedef struct psci_cmo_region {
+	const char *name;
+	uintptr_t base;
+	uintptr_t end;
+	size_t stride;
+} psci_cmo_region_t;
+
+#if PSCI_TARGETED_CMO && defined(IMAGE_BL31)
+#define REGISTER_PSCI_CMO_REGION(_name, _base, _end, _stride)		\
+	static const psci_cmo_region_t __psci_cmo_region_ ## _name	\
+	__section("psci_cmo_regions") __used = {			\
+		.name = #_name,						\
+		.base = (uintptr_t)(_base),				\
+		.end = (uintptr_t)(_end),				\
+		.stride = (_stride)					\
+	}
+#else
+#define REGISTER_PSCI_CMO_REGION(_name, _base, _end, _stride)		\
+	CASSERT(1, __psci_cmo_region_unused_ ## _name)
+#endif
+
+/* Convenience macros to register an array shared by all CPUs or one per CPU */
+#define REGISTER_PSCI_CMO_ARRAY(_array)					\
+	REGISTER_PSCI_CMO_REGION(_array, &(_array)[0],			\
+				 &(_array)[ARRAY_SIZE(_array)], 0U)
+#define REGISTER_PSCI_CMO_PERCPU_ARRAY(_array)				\
+	REGISTER_PSCI_CMO_REGION(_array, &(_array)[0], &(_array)[1],	\
+				 sizeof((_array)[0]))
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* PSCI_CMO_H */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_IDLE_POLICY_H
+#define PSCI_IDLE_POLICY_H
+
+#include <lib/utils_def.h>
+
+/*
+ * SiP function ID for setting the bounds of the PSCI idle state policy. The
+ * command is passed in x1, the arguments in x2-x4.
+ */
+#define PSCI_IDLE_POLICY_SMC_32		U(0x82000044)
+#define PSCI_IDLE_POLICY_SMC_64		U(0xC2000044)
+#define PSCI_IDLE_POLICY_FID_VALUE	U(0x44)
+#define is_psci_idle_policy_fid(_fid)	\
+	(((_fid) & FUNCID_NUM_MASK) == PSCI_IDLE_POLICY_FID_VALUE)
+
+/*
+ * PSCI_IDLE_POLICY_SET: x2 = MPIDR, x3 = highest power level CPU_SUSPEND
+ *	requests of the CPU may be promoted to, PSCI_CPU_PWR_LVL to never
+ *	promote them, x4 = 1 to let them be demoted, 0 not to
+ * PSCI_IDLE_POLICY_GET: x2 = MPIDR
+ *	returns x1 = highest promotion level, x2 = whether demotion is allowed,
+ *		x3 = number of demotions, x4 = number of promotions
+ */
+#define PSCI_IDLE_POLICY_SET		U(0)
+#define PSCI_IDLE_POLICY_GET		U(1)
+
+#define PSCI_IDLE_POLICY_E_INVALID_PARAMS	-2
+
+/*
+ * Number of past idle periods of a CPU the policy bases its decisions on. A
+ * state is demoted when more than half of them were shorter than its target
+ * residency, promoted when none of them were.
+ */
+#define PSCI_IDLE_POLICY_HISTORY	U(8)
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#include <common/runtime_svc.h>
+
+uintptr_t psci_idle_policy_smc_handler(unsigned int smc_fid,
+				       u_register_t cmd,
+				       u_register_t x2,
+				       u_register_t x3,
+				       u_register_t x4,
+				       void *cookie,
+				       void *handle,
+				       u_register_t flags);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* PSCI_IDLE_POLICY_H */
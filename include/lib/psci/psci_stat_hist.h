@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_STAT_HIST_H
+#define PSCI_STAT_HIST_H
+
+#include <lib/utils_def.h>
+
+/*
+ * SiP function ID for reading the extended PSCI statistics. The command is
+ * passed in x1, the arguments in x2-x4. As for PSCI_STAT_RESIDENCY and
+ * PSCI_STAT_COUNT, a power domain and its state are identified by the MPIDR of
+ * a CPU in x2 and a power_state parameter of CPU_SUSPEND in x3.
+ */
+#define PSCI_STAT_HIST_SMC_32		U(0x82000043)
+#define PSCI_STAT_HIST_SMC_64		U(0xC2000043)
+#define PSCI_STAT_HIST_FID_VALUE	U(0x43)
+#define is_psci_stat_hist_fid(_fid)	\
+	(((_fid) & FUNCID_NUM_MASK) == PSCI_STAT_HIST_FID_VALUE)
+
+/*
+ * PSCI_STAT_HIST_INFO:
+ *	returns x1 = number of histogram buckets, x2 = counter frequency
+ * PSCI_STAT_HIST_STATE: x2 = MPIDR, x3 = power_state
+ *	returns x1 = number of entries, x2 = total residency in microseconds,
+ *		x3 = premature wakeups, x4 = total entry latency,
+ *		x5 = total exit latency, x6 = longest entry latency,
+ *		x7 = longest exit latency, latencies in ticks
+ * PSCI_STAT_HIST_BKTS: x2 = MPIDR, x3 = power_state, x4 = first bucket
+ *	returns x1-x6 = histogram buckets starting at x4
+ */
+#define PSCI_STAT_HIST_INFO		U(0)
+#define PSCI_STAT_HIST_STATE		U(1)
+#define PSCI_STAT_HIST_BKTS		U(2)
+
+#define PSCI_STAT_HIST_BUCKETS_PER_CALL	U(6)
+
+/*
+ * Bucket n of a residency histogram counts the stays of [2^n, 2^(n+1))
+ * microseconds in the state, the last bucket also counts the longer ones.
+ */
+#define PSCI_STAT_HIST_BUCKETS		U(24)
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#include <common/runtime_svc.h>
+
+uintptr_t psci_stat_hist_smc_handler(unsigned int smc_fid,
+				     u_register_t cmd,
+				     u_register_t x2,
+				     u_register_t x3,
+				     u_register_t x4,
+				     void *cookie,
+				     void *handle,
+				     u_register_t flags);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* PSCI_STAT_HIST_H */
@@ -18,6 +18,17 @@ typedef struct spinlock {
 void spin_lock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
 
+#if LOCK_PROFILING && defined(IMAGE_BL31)
+/* Route the C callers through the profiler, see lib/locks/lock_prof.c */
+void lock_prof_spin_lock(spinlock_t *lock);
+void lock_prof_spin_unlock(spinlock_t *lock);
+
+#ifndef LOCK_PROF_NO_WRAPPERS
+#define spin_lock(_lock)	lock_prof_spin_lock(_lock)
+#define spin_unlock(_lock)	lock_prof_spin_unlock(_lock)
+#endif
+#endif
+
 #else
 
 /* Spin lock definitions for use in assembly */
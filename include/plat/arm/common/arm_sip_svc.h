@@ -25,6 +25,23 @@
 /* DEBUGFS_SMC_32			0x82000030U */
 /* DEBUGFS_SMC_64			0xC2000030U */
 
+/* SMC_ACCT_SMC_32			0x82000040U */
+/* SMC_ACCT_SMC_64			0xC2000040U */
+
+/* SMC_BATCH_SMC_64			0xC2000041U */
+
+/* LOCK_PROF_SMC_32			0x82000042U */
+/* LOCK_PROF_SMC_64			0xC2000042U */
+
+/* PSCI_STAT_HIST_SMC_32		0x82000043U */
+/* PSCI_STAT_HIST_SMC_64		0xC2000043U */
+
+/* PSCI_IDLE_POLICY_SMC_32		0x82000044U */
+/* PSCI_IDLE_POLICY_SMC_64		0xC2000044U */
+
+/* PSCI_BULK_ON_SMC_32			0x82000045U */
+/* PSCI_BULK_ON_SMC_64			0xC2000045U */
+
 /*
  * Arm Ethos-N NPU SiP SMC function IDs
  * 0xC2000050-0xC200005F
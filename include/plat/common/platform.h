@@ -7,6 +7,7 @@
 #ifndef PLATFORM_H
 #define PLATFORM_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <lib/psci/psci.h>
@@ -143,6 +144,15 @@ void plat_sdei_handle_masked_trigger(uint64_t mpidr, unsigned int intr);
 void plat_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
 
+#if SMC_LIGHT_ENTRY
+bool plat_is_light_smc(uint32_t smc_fid);
+#endif
+
+#if SMC_BATCH
+bool plat_is_batchable_smc(uint32_t smc_fid);
+int plat_smc_batch_validate_buf(uintptr_t pa, size_t size);
+#endif
+
 /*
  * The following function is mandatory when the
  * firmware update feature is used.
@@ -264,9 +274,12 @@ void plat_psci_stat_accounting_stop(const psci_power_state_t *state_info);
 u_register_t plat_psci_stat_get_residency(unsigned int lvl,
 			const psci_power_state_t *state_info,
 			unsigned int last_cpu_idx);
+u_register_t plat_psci_stat_get_target_residency(unsigned int lvl,
+			plat_local_state_t local_state);
 plat_local_state_t plat_get_target_pwr_state(unsigned int lvl,
 			const plat_local_state_t *states,
 			unsigned int ncpu);
+bool plat_psci_pwrdown_hw_cache_clean(unsigned int pwr_lvl);
 
 /*******************************************************************************
  * Optional BL31 functions (may be overridden)
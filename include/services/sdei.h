@@ -7,6 +7,7 @@
 #ifndef SDEI_H
 #define SDEI_H
 
+#include <lib/lock_prof.h>
 #include <lib/spinlock.h>
 #include <lib/utils_def.h>
 #include <services/sdei_flags.h>
@@ -84,6 +85,10 @@
 	sdei_entry_t sdei_private_event_table \
 		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
 	sdei_entry_t sdei_shared_event_table[ARRAY_SIZE(_shared)]; \
+	REGISTER_LOCK_PROF(sdei_private_maps, &(_private)[0].lock, \
+			   sizeof((_private)[0]), ARRAY_SIZE(_private)); \
+	REGISTER_LOCK_PROF(sdei_shared_maps, &(_shared)[0].lock, \
+			   sizeof((_shared)[0]), ARRAY_SIZE(_shared)); \
 	const sdei_mapping_t sdei_global_mappings[] = { \
 		[SDEI_MAP_IDX_PRIV_] = { \
 			.map = (_private), \
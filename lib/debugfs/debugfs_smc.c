@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <lib/debugfs.h>
+#include <lib/lock_prof.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
@@ -56,6 +57,7 @@ static union debugfs_parms {
 /* debugfs_access_lock protects shared buffer and internal */
 /* FS functions from concurrent acccesses.                 */
 static spinlock_t debugfs_access_lock;
+REGISTER_LOCK_PROF_LOCK(debugfs_access_lock);
 
 static bool debugfs_initialized;
 
@@ -34,6 +34,7 @@ enum {
 	DEV_ROOT_QDEV,
 	DEV_ROOT_QFIP,
 	DEV_ROOT_QBLOBS,
+	DEV_ROOT_QSMCACCT,
 	DEV_ROOT_QBLOBCTL,
 	DEV_ROOT_QPSCI
 };
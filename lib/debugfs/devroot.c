@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <common/debug.h>
+#include <common/runtime_svc_acct.h>
 #include <lib/debugfs.h>
 
 #include "blobs.h"
@@ -21,6 +22,10 @@ static const dirtab_t dirtab[] = {
 };
 
 static const dirtab_t devfstab[] = {
+#if SMC_ACCOUNTING
+	{"smc_acct", DEV_ROOT_QSMCACCT, sizeof(smc_acct_stats), O_READ,
+	 smc_acct_stats}
+#endif
 };
 
 /*******************************************************************************
@@ -72,6 +77,15 @@ static int rootread(chan_t *channel, void *buf, int size)
 		return dirread(channel, dir, NULL, 0, rootgen);
 	}
 
+#if SMC_ACCOUNTING
+	/* Raw smc_acct_stats, one smc_acct_cpu_t per core position */
+	if (channel->qid == DEV_ROOT_QSMCACCT) {
+		dp = &devfstab[0];
+		return buf_to_channel(channel, buf, dp->data, size,
+				      dp->length);
+	}
+#endif
+
 	/* Only makes sense when using debug language */
 	assert(channel->qid != DEV_ROOT_QBLOBCTL);
 
@@ -17,6 +17,7 @@
 #include <common/bl_common.h>
 #include <context.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
 #include <lib/extensions/amu.h>
 #include <lib/extensions/mpam.h>
@@ -24,6 +25,27 @@
 #include <lib/extensions/sve.h>
 #include <lib/extensions/twed.h>
 #include <lib/utils.h>
+#include <plat/common/platform.h>
+
+/* Values cm_setup_context() initialises a context with */
+typedef struct cm_ep_regs {
+	u_register_t scr_el3;
+	u_register_t sctlr_el1;
+	u_register_t actlr_el1;
+} cm_ep_regs_t;
+
+/* Values of the EL2 registers when the normal world does not use EL2 */
+typedef struct cm_el2_unused_regs {
+	u_register_t hcr_el2;
+	u_register_t cptr_el2;
+	u_register_t cnthctl_el2;
+	u_register_t vpidr_el2;
+	u_register_t vmpidr_el2;
+	u_register_t vttbr_el2;
+	u_register_t mdcr_el2;
+	u_register_t hstr_el2;
+	u_register_t cnthp_ctl_el2;
+} cm_el2_unused_regs_t;
 
 
 /*******************************************************************************
@@ -48,34 +70,14 @@ void __init cm_init(void)
 }
 
 /*******************************************************************************
- * The following function initializes the cpu_context 'ctx' for
- * first use, and sets the initial entrypoint state as specified by the
- * entry_point_info structure.
- *
- * The security state to initialize is determined by the SECURE attribute
- * of the entry_point_info.
- *
- * The EE and ST attributes are used to configure the endianness and secure
- * timer availability for the new execution context.
- *
- * To prepare the register state for entry call cm_prepare_el3_exit() and
- * el3_exit(). For Secure-EL1 cm_prepare_el3_exit() is equivalent to
- * cm_e1_sysreg_context_restore().
+ * Compute the values of SCR_EL3, SCTLR_EL1 and ACTLR_EL1 cm_setup_context()
+ * initialises a context for 'ep' with.
  ******************************************************************************/
-void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep)
+static void cm_setup_ep_regs(const entry_point_info_t *ep, cm_ep_regs_t *regs)
 {
-	unsigned int security_state;
+	unsigned int security_state = GET_SECURITY_STATE(ep->h.attr);
 	u_register_t scr_el3;
-	el3_state_t *state;
-	gp_regs_t *gp_regs;
-	u_register_t sctlr_elx, actlr_elx;
-
-	assert(ctx != NULL);
-
-	security_state = GET_SECURITY_STATE(ep->h.attr);
-
-	/* Clear any residual register values from the context */
-	zeromem(ctx, sizeof(*ctx));
+	u_register_t sctlr_elx;
 
 	/*
 	 * SCR_EL3 was initialised during reset sequence in macro
@@ -284,12 +286,8 @@ void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep)
 		}
 	}
 
-	/*
-	 * Store the initialised SCTLR_EL1 value in the cpu_context - SCTLR_EL2
-	 * and other EL2 registers are set up by cm_prepare_ns_entry() as they
-	 * are not part of the stored cpu_context.
-	 */
-	write_ctx_reg(get_el1_sysregs_ctx(ctx), CTX_SCTLR_EL1, sctlr_elx);
+	regs->scr_el3 = scr_el3;
+	regs->sctlr_el1 = sctlr_elx;
 
 	/*
 	 * Base the context ACTLR_EL1 on the current value, as it is
@@ -298,15 +296,333 @@ void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep)
 	 * problems for processor cores that don't expect certain bits to
 	 * be zero.
 	 */
-	actlr_elx = read_actlr_el1();
-	write_ctx_reg((get_el1_sysregs_ctx(ctx)), (CTX_ACTLR_EL1), (actlr_elx));
+	regs->actlr_el1 = read_actlr_el1();
+}
+
+/*******************************************************************************
+ * Compute the values cm_prepare_el3_exit() programs the EL2 registers with when
+ * EL2 is implemented but the normal world, entered with 'scr_el3', does not
+ * use it.
+ ******************************************************************************/
+static void cm_setup_el2_unused_regs(u_register_t scr_el3,
+				     cm_el2_unused_regs_t *regs)
+{
+	u_register_t hcr_el2 = 0U, mdcr_el2;
+
+	/*
+	 * Set EL2 register width appropriately: Set HCR_EL2
+	 * field to match SCR_EL3.RW.
+	 */
+	if ((scr_el3 & SCR_RW_BIT) != 0U)
+		hcr_el2 |= HCR_RW_BIT;
+
+	/*
+	 * For Armv8.3 pointer authentication feature, disable
+	 * traps to EL2 when accessing key registers or using
+	 * pointer authentication instructions from lower ELs.
+	 */
+	hcr_el2 |= (HCR_API_BIT | HCR_APK_BIT);
+
+	regs->hcr_el2 = hcr_el2;
+
+	/*
+	 * Initialise CPTR_EL2 setting all fields rather than
+	 * relying on the hw. All fields have architecturally
+	 * UNKNOWN reset values.
+	 *
+	 * CPTR_EL2.TCPAC: Set to zero so that Non-secure EL1
+	 *  accesses to the CPACR_EL1 or CPACR from both
+	 *  Execution states do not trap to EL2.
+	 *
+	 * CPTR_EL2.TTA: Set to zero so that Non-secure System
+	 *  register accesses to the trace registers from both
+	 *  Execution states do not trap to EL2.
+	 *
+	 * CPTR_EL2.TFP: Set to zero so that Non-secure accesses
+	 *  to SIMD and floating-point functionality from both
+	 *  Execution states do not trap to EL2.
+	 */
+	regs->cptr_el2 = CPTR_EL2_RESET_VAL &
+			~(CPTR_EL2_TCPAC_BIT | CPTR_EL2_TTA_BIT
+			| CPTR_EL2_TFP_BIT);
+
+	/*
+	 * Initialise CNTHCTL_EL2. All fields are
+	 * architecturally UNKNOWN on reset and are set to zero
+	 * except for field(s) listed below.
+	 *
+	 * CNTHCTL_EL2.EL1PCEN: Set to one to disable traps to
+	 *  Hyp mode of Non-secure EL0 and EL1 accesses to the
+	 *  physical timer registers.
+	 *
+	 * CNTHCTL_EL2.EL1PCTEN: Set to one to disable traps to
+	 *  Hyp mode of  Non-secure EL0 and EL1 accesses to the
+	 *  physical counter registers.
+	 */
+	regs->cnthctl_el2 = CNTHCTL_RESET_VAL |
+				EL1PCEN_BIT | EL1PCTEN_BIT;
+
+	/*
+	 * Set VPIDR_EL2 and VMPIDR_EL2 to match MIDR_EL1 and
+	 * MPIDR_EL1 respectively.
+	 */
+	regs->vpidr_el2 = read_midr_el1();
+	regs->vmpidr_el2 = read_mpidr_el1();
+
+	/*
+	 * Initialise VTTBR_EL2. All fields are architecturally
+	 * UNKNOWN on reset.
+	 *
+	 * VTTBR_EL2.VMID: Set to zero. Even though EL1&0 stage
+	 *  2 address translation is disabled, cache maintenance
+	 *  operations depend on the VMID.
+	 *
+	 * VTTBR_EL2.BADDR: Set to zero as EL1&0 stage 2 address
+	 *  translation is disabled.
+	 */
+	regs->vttbr_el2 = VTTBR_RESET_VAL &
+		~((VTTBR_VMID_MASK << VTTBR_VMID_SHIFT)
+		| (VTTBR_BADDR_MASK << VTTBR_BADDR_SHIFT));
+
+	/*
+	 * Initialise MDCR_EL2, setting all fields rather than
+	 * relying on hw. Some fields are architecturally
+	 * UNKNOWN on reset.
+	 *
+	 * MDCR_EL2.HLP: Set to one so that event counter
+	 *  overflow, that is recorded in PMOVSCLR_EL0[0-30],
+	 *  occurs on the increment that changes
+	 *  PMEVCNTR<n>_EL0[63] from 1 to 0, when ARMv8.5-PMU is
+	 *  implemented. This bit is RES0 in versions of the
+	 *  architecture earlier than ARMv8.5, setting it to 1
+	 *  doesn't have any effect on them.
+	 *
+	 * MDCR_EL2.TTRF: Set to zero so that access to Trace
+	 *  Filter Control register TRFCR_EL1 at EL1 is not
+	 *  trapped to EL2. This bit is RES0 in versions of
+	 *  the architecture earlier than ARMv8.4.
+	 *
+	 * MDCR_EL2.HPMD: Set to one so that event counting is
+	 *  prohibited at EL2. This bit is RES0 in versions of
+	 *  the architecture earlier than ARMv8.1, setting it
+	 *  to 1 doesn't have any effect on them.
+	 *
+	 * MDCR_EL2.TPMS: Set to zero so that accesses to
+	 *  Statistical Profiling control registers from EL1
+	 *  do not trap to EL2. This bit is RES0 when SPE is
+	 *  not implemented.
+	 *
+	 * MDCR_EL2.TDRA: Set to zero so that Non-secure EL0 and
+	 *  EL1 System register accesses to the Debug ROM
+	 *  registers are not trapped to EL2.
+	 *
+	 * MDCR_EL2.TDOSA: Set to zero so that Non-secure EL1
+	 *  System register accesses to the powerdown debug
+	 *  registers are not trapped to EL2.
+	 *
+	 * MDCR_EL2.TDA: Set to zero so that System register
+	 *  accesses to the debug registers do not trap to EL2.
+	 *
+	 * MDCR_EL2.TDE: Set to zero so that debug exceptions
+	 *  are not routed to EL2.
+	 *
+	 * MDCR_EL2.HPME: Set to zero to disable EL2 Performance
+	 *  Monitors.
+	 *
+	 * MDCR_EL2.TPM: Set to zero so that Non-secure EL0 and
+	 *  EL1 accesses to all Performance Monitors registers
+	 *  are not trapped to EL2.
+	 *
+	 * MDCR_EL2.TPMCR: Set to zero so that Non-secure EL0
+	 *  and EL1 accesses to the PMCR_EL0 or PMCR are not
+	 *  trapped to EL2.
+	 *
+	 * MDCR_EL2.HPMN: Set to value of PMCR_EL0.N which is the
+	 *  architecturally-defined reset value.
+	 */
+	mdcr_el2 = ((MDCR_EL2_RESET_VAL | MDCR_EL2_HLP |
+		     MDCR_EL2_HPMD) |
+		   ((read_pmcr_el0() & PMCR_EL0_N_BITS)
+		   >> PMCR_EL0_N_SHIFT)) &
+		   ~(MDCR_EL2_TTRF | MDCR_EL2_TPMS |
+		     MDCR_EL2_TDRA_BIT | MDCR_EL2_TDOSA_BIT |
+		     MDCR_EL2_TDA_BIT | MDCR_EL2_TDE_BIT |
+		     MDCR_EL2_HPME_BIT | MDCR_EL2_TPM_BIT |
+		     MDCR_EL2_TPMCR_BIT);
+
+	regs->mdcr_el2 = mdcr_el2;
+
+	/*
+	 * Initialise HSTR_EL2. All fields are architecturally
+	 * UNKNOWN on reset.
+	 *
+	 * HSTR_EL2.T<n>: Set all these fields to zero so that
+	 *  Non-secure EL0 or EL1 accesses to System registers
+	 *  do not trap to EL2.
+	 */
+	regs->hstr_el2 = HSTR_EL2_RESET_VAL & ~(HSTR_EL2_T_MASK);
+	/*
+	 * Initialise CNTHP_CTL_EL2. All fields are
+	 * architecturally UNKNOWN on reset.
+	 *
+	 * CNTHP_CTL_EL2:ENABLE: Set to zero to disable the EL2
+	 *  physical timer and prevent timer interrupts.
+	 */
+	regs->cnthp_ctl_el2 = CNTHP_CTL_RESET_VAL &
+				~(CNTHP_CTL_ENABLE_BIT);
+}
+
+static void cm_write_el2_unused_regs(const cm_el2_unused_regs_t *regs)
+{
+	write_hcr_el2(regs->hcr_el2);
+	write_cptr_el2(regs->cptr_el2);
+	write_cnthctl_el2(regs->cnthctl_el2);
+
+	/*
+	 * Initialise CNTVOFF_EL2 to zero as it resets to an
+	 * architecturally UNKNOWN value.
+	 */
+	write_cntvoff_el2(0);
+
+	write_vpidr_el2(regs->vpidr_el2);
+	write_vmpidr_el2(regs->vmpidr_el2);
+	write_vttbr_el2(regs->vttbr_el2);
+	write_mdcr_el2(regs->mdcr_el2);
+	write_hstr_el2(regs->hstr_el2);
+	write_cnthp_ctl_el2(regs->cnthp_ctl_el2);
+}
+
+#if WARMBOOT_GOLDEN_CTX
+/*******************************************************************************
+ * Per-cpu golden images of the state cm_setup_context() and
+ * cm_prepare_el3_exit() derive from the ID registers, the interrupt routing
+ * model and the entrypoint attributes. A cpu computes them the first time it
+ * needs them and copies them on every later CPU_ON, CPU_SUSPEND and wake-up,
+ * until cm_invalidate_golden_ctx() marks all of them stale after a runtime
+ * change of that configuration. Each image is only used by its own cpu.
+ ******************************************************************************/
+typedef struct cm_golden_ctx {
+	/* Image of the context set up for each security state */
+	unsigned int ep_gen[2];
+	u_register_t ep_key[2];
+	cm_ep_regs_t ep[2];
+
+	/* Image of the EL2 registers when the normal world does not use EL2 */
+	unsigned int el2_gen;
+	u_register_t el2_key;
+	cm_el2_unused_regs_t el2;
+} __aligned(CACHE_WRITEBACK_GRANULE) cm_golden_ctx_t;
+
+static cm_golden_ctx_t cm_golden_ctx[PLATFORM_CORE_COUNT];
+
+/*
+ * Images whose generation differs from this one are stale. It is bumped with
+ * release semantics after a configuration change, and read with acquire
+ * semantics before an image is rebuilt, so that the rebuild sees the change.
+ */
+static unsigned int cm_golden_gen = 1U;
+
+/*******************************************************************************
+ * Mark the golden images of all cpus stale. To be called whenever a runtime
+ * service changes the configuration they derive from, e.g. the interrupt
+ * routing model, once the change is made.
+ ******************************************************************************/
+void cm_invalidate_golden_ctx(void)
+{
+	(void)__atomic_fetch_add(&cm_golden_gen, 1U, __ATOMIC_RELEASE);
+}
+
+/* Fields of the entrypoint the values of cm_ep_regs_t depend on */
+static u_register_t cm_golden_ep_key(const entry_point_info_t *ep)
+{
+	return ((u_register_t)ep->h.attr << 32) |
+		(GET_RW(ep->spsr) << 8) | (GET_EL(ep->spsr) << 4) |
+		GET_M32(ep->spsr);
+}
+
+static void cm_get_golden_ep_regs(const entry_point_info_t *ep,
+				  cm_ep_regs_t *regs)
+{
+	cm_golden_ctx_t *golden = &cm_golden_ctx[plat_my_core_pos()];
+	unsigned int security_state = GET_SECURITY_STATE(ep->h.attr);
+	u_register_t key = cm_golden_ep_key(ep);
+	unsigned int gen = __atomic_load_n(&cm_golden_gen, __ATOMIC_ACQUIRE);
+
+	assert(security_state <= NON_SECURE);
+
+	if ((golden->ep_gen[security_state] != gen) ||
+	    (golden->ep_key[security_state] != key)) {
+		cm_setup_ep_regs(ep, &golden->ep[security_state]);
+		golden->ep_key[security_state] = key;
+		golden->ep_gen[security_state] = gen;
+	}
+
+	*regs = golden->ep[security_state];
+}
+
+static void cm_get_golden_el2_regs(u_register_t scr_el3,
+				   cm_el2_unused_regs_t *regs)
+{
+	cm_golden_ctx_t *golden = &cm_golden_ctx[plat_my_core_pos()];
+	u_register_t key = scr_el3 & SCR_RW_BIT;
+	unsigned int gen = __atomic_load_n(&cm_golden_gen, __ATOMIC_ACQUIRE);
+
+	if ((golden->el2_gen != gen) || (golden->el2_key != key)) {
+		cm_setup_el2_unused_regs(scr_el3, &golden->el2);
+		golden->el2_key = key;
+		golden->el2_gen = gen;
+	}
+
+	*regs = golden->el2;
+}
+#endif /* WARMBOOT_GOLDEN_CTX */
+
+/*******************************************************************************
+ * The following function initializes the cpu_context 'ctx' for
+ * first use, and sets the initial entrypoint state as specified by the
+ * entry_point_info structure.
+ *
+ * The security state to initialize is determined by the SECURE attribute
+ * of the entry_point_info.
+ *
+ * The EE and ST attributes are used to configure the endianness and secure
+ * timer availability for the new execution context.
+ *
+ * To prepare the register state for entry call cm_prepare_el3_exit() and
+ * el3_exit(). For Secure-EL1 cm_prepare_el3_exit() is equivalent to
+ * cm_e1_sysreg_context_restore().
+ ******************************************************************************/
+void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep)
+{
+	cm_ep_regs_t regs;
+	el3_state_t *state;
+	gp_regs_t *gp_regs;
+
+	assert(ctx != NULL);
+
+	/* Clear any residual register values from the context */
+	zeromem(ctx, sizeof(*ctx));
+
+#if WARMBOOT_GOLDEN_CTX
+	cm_get_golden_ep_regs(ep, &regs);
+#else
+	cm_setup_ep_regs(ep, &regs);
+#endif
+
+	/*
+	 * Store the initialised SCTLR_EL1 value in the cpu_context - SCTLR_EL2
+	 * and other EL2 registers are set up by cm_prepare_ns_entry() as they
+	 * are not part of the stored cpu_context.
+	 */
+	write_ctx_reg(get_el1_sysregs_ctx(ctx), CTX_SCTLR_EL1, regs.sctlr_el1);
+	write_ctx_reg(get_el1_sysregs_ctx(ctx), CTX_ACTLR_EL1, regs.actlr_el1);
 
 	/*
 	 * Populate EL3 state so that we've the right context
 	 * before doing ERET
 	 */
 	state = get_el3state_ctx(ctx);
-	write_ctx_reg(state, CTX_SCR_EL3, scr_el3);
+	write_ctx_reg(state, CTX_SCR_EL3, regs.scr_el3);
 	write_ctx_reg(state, CTX_ELR_EL3, ep->pc);
 	write_ctx_reg(state, CTX_SPSR_EL3, ep->spsr);
 
@@ -379,10 +695,10 @@ void cm_init_my_context(const entry_point_info_t *ep)
  ******************************************************************************/
 void cm_prepare_el3_exit(uint32_t security_state)
 {
-	u_register_t sctlr_elx, scr_el3, mdcr_el2;
+	u_register_t sctlr_elx, scr_el3;
 	cpu_context_t *ctx = cm_get_context(security_state);
+	cm_el2_unused_regs_t el2_regs;
 	bool el2_unused = false;
-	uint64_t hcr_el2 = 0U;
 
 	assert(ctx != NULL);
 
@@ -410,173 +726,13 @@ void cm_prepare_el3_exit(uint32_t security_state)
 			/*
 			 * EL2 present but unused, need to disable safely.
 			 * SCTLR_EL2 can be ignored in this case.
-			 *
-			 * Set EL2 register width appropriately: Set HCR_EL2
-			 * field to match SCR_EL3.RW.
-			 */
-			if ((scr_el3 & SCR_RW_BIT) != 0U)
-				hcr_el2 |= HCR_RW_BIT;
-
-			/*
-			 * For Armv8.3 pointer authentication feature, disable
-			 * traps to EL2 when accessing key registers or using
-			 * pointer authentication instructions from lower ELs.
 			 */
-			hcr_el2 |= (HCR_API_BIT | HCR_APK_BIT);
-
-			write_hcr_el2(hcr_el2);
-
-			/*
-			 * Initialise CPTR_EL2 setting all fields rather than
-			 * relying on the hw. All fields have architecturally
-			 * UNKNOWN reset values.
-			 *
-			 * CPTR_EL2.TCPAC: Set to zero so that Non-secure EL1
-			 *  accesses to the CPACR_EL1 or CPACR from both
-			 *  Execution states do not trap to EL2.
-			 *
-			 * CPTR_EL2.TTA: Set to zero so that Non-secure System
-			 *  register accesses to the trace registers from both
-			 *  Execution states do not trap to EL2.
-			 *
-			 * CPTR_EL2.TFP: Set to zero so that Non-secure accesses
-			 *  to SIMD and floating-point functionality from both
-			 *  Execution states do not trap to EL2.
-			 */
-			write_cptr_el2(CPTR_EL2_RESET_VAL &
-					~(CPTR_EL2_TCPAC_BIT | CPTR_EL2_TTA_BIT
-					| CPTR_EL2_TFP_BIT));
-
-			/*
-			 * Initialise CNTHCTL_EL2. All fields are
-			 * architecturally UNKNOWN on reset and are set to zero
-			 * except for field(s) listed below.
-			 *
-			 * CNTHCTL_EL2.EL1PCEN: Set to one to disable traps to
-			 *  Hyp mode of Non-secure EL0 and EL1 accesses to the
-			 *  physical timer registers.
-			 *
-			 * CNTHCTL_EL2.EL1PCTEN: Set to one to disable traps to
-			 *  Hyp mode of  Non-secure EL0 and EL1 accesses to the
-			 *  physical counter registers.
-			 */
-			write_cnthctl_el2(CNTHCTL_RESET_VAL |
-						EL1PCEN_BIT | EL1PCTEN_BIT);
-
-			/*
-			 * Initialise CNTVOFF_EL2 to zero as it resets to an
-			 * architecturally UNKNOWN value.
-			 */
-			write_cntvoff_el2(0);
-
-			/*
-			 * Set VPIDR_EL2 and VMPIDR_EL2 to match MIDR_EL1 and
-			 * MPIDR_EL1 respectively.
-			 */
-			write_vpidr_el2(read_midr_el1());
-			write_vmpidr_el2(read_mpidr_el1());
-
-			/*
-			 * Initialise VTTBR_EL2. All fields are architecturally
-			 * UNKNOWN on reset.
-			 *
-			 * VTTBR_EL2.VMID: Set to zero. Even though EL1&0 stage
-			 *  2 address translation is disabled, cache maintenance
-			 *  operations depend on the VMID.
-			 *
-			 * VTTBR_EL2.BADDR: Set to zero as EL1&0 stage 2 address
-			 *  translation is disabled.
-			 */
-			write_vttbr_el2(VTTBR_RESET_VAL &
-				~((VTTBR_VMID_MASK << VTTBR_VMID_SHIFT)
-				| (VTTBR_BADDR_MASK << VTTBR_BADDR_SHIFT)));
-
-			/*
-			 * Initialise MDCR_EL2, setting all fields rather than
-			 * relying on hw. Some fields are architecturally
-			 * UNKNOWN on reset.
-			 *
-			 * MDCR_EL2.HLP: Set to one so that event counter
-			 *  overflow, that is recorded in PMOVSCLR_EL0[0-30],
-			 *  occurs on the increment that changes
-			 *  PMEVCNTR<n>_EL0[63] from 1 to 0, when ARMv8.5-PMU is
-			 *  implemented. This bit is RES0 in versions of the
-			 *  architecture earlier than ARMv8.5, setting it to 1
-			 *  doesn't have any effect on them.
-			 *
-			 * MDCR_EL2.TTRF: Set to zero so that access to Trace
-			 *  Filter Control register TRFCR_EL1 at EL1 is not
-			 *  trapped to EL2. This bit is RES0 in versions of
-			 *  the architecture earlier than ARMv8.4.
-			 *
-			 * MDCR_EL2.HPMD: Set to one so that event counting is
-			 *  prohibited at EL2. This bit is RES0 in versions of
-			 *  the architecture earlier than ARMv8.1, setting it
-			 *  to 1 doesn't have any effect on them.
-			 *
-			 * MDCR_EL2.TPMS: Set to zero so that accesses to
-			 *  Statistical Profiling control registers from EL1
-			 *  do not trap to EL2. This bit is RES0 when SPE is
-			 *  not implemented.
-			 *
-			 * MDCR_EL2.TDRA: Set to zero so that Non-secure EL0 and
-			 *  EL1 System register accesses to the Debug ROM
-			 *  registers are not trapped to EL2.
-			 *
-			 * MDCR_EL2.TDOSA: Set to zero so that Non-secure EL1
-			 *  System register accesses to the powerdown debug
-			 *  registers are not trapped to EL2.
-			 *
-			 * MDCR_EL2.TDA: Set to zero so that System register
-			 *  accesses to the debug registers do not trap to EL2.
-			 *
-			 * MDCR_EL2.TDE: Set to zero so that debug exceptions
-			 *  are not routed to EL2.
-			 *
-			 * MDCR_EL2.HPME: Set to zero to disable EL2 Performance
-			 *  Monitors.
-			 *
-			 * MDCR_EL2.TPM: Set to zero so that Non-secure EL0 and
-			 *  EL1 accesses to all Performance Monitors registers
-			 *  are not trapped to EL2.
-			 *
-			 * MDCR_EL2.TPMCR: Set to zero so that Non-secure EL0
-			 *  and EL1 accesses to the PMCR_EL0 or PMCR are not
-			 *  trapped to EL2.
-			 *
-			 * MDCR_EL2.HPMN: Set to value of PMCR_EL0.N which is the
-			 *  architecturally-defined reset value.
-			 */
-			mdcr_el2 = ((MDCR_EL2_RESET_VAL | MDCR_EL2_HLP |
-				     MDCR_EL2_HPMD) |
-				   ((read_pmcr_el0() & PMCR_EL0_N_BITS)
-				   >> PMCR_EL0_N_SHIFT)) &
-				   ~(MDCR_EL2_TTRF | MDCR_EL2_TPMS |
-				     MDCR_EL2_TDRA_BIT | MDCR_EL2_TDOSA_BIT |
-				     MDCR_EL2_TDA_BIT | MDCR_EL2_TDE_BIT |
-				     MDCR_EL2_HPME_BIT | MDCR_EL2_TPM_BIT |
-				     MDCR_EL2_TPMCR_BIT);
-
-			write_mdcr_el2(mdcr_el2);
-
-			/*
-			 * Initialise HSTR_EL2. All fields are architecturally
-			 * UNKNOWN on reset.
-			 *
-			 * HSTR_EL2.T<n>: Set all these fields to zero so that
-			 *  Non-secure EL0 or EL1 accesses to System registers
-			 *  do not trap to EL2.
-			 */
-			write_hstr_el2(HSTR_EL2_RESET_VAL & ~(HSTR_EL2_T_MASK));
-			/*
-			 * Initialise CNTHP_CTL_EL2. All fields are
-			 * architecturally UNKNOWN on reset.
-			 *
-			 * CNTHP_CTL_EL2:ENABLE: Set to zero to disable the EL2
-			 *  physical timer and prevent timer interrupts.
-			 */
-			write_cnthp_ctl_el2(CNTHP_CTL_RESET_VAL &
-						~(CNTHP_CTL_ENABLE_BIT));
+#if WARMBOOT_GOLDEN_CTX
+			cm_get_golden_el2_regs(scr_el3, &el2_regs);
+#else
+			cm_setup_el2_unused_regs(scr_el3, &el2_regs);
+#endif
+			cm_write_el2_unused_regs(&el2_regs);
 		}
 		enable_extensions_nonsecure(el2_unused);
 	}
@@ -653,6 +809,64 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 #endif
 }
 
+/*******************************************************************************
+ * Save and restore functions of the register groups of the Titanium
+ * 'el2_sys_regs' block.
+ ******************************************************************************/
+typedef struct el2_grp_desc {
+	void (*save)(el2_sys_regs_t *regs);
+	void (*restore)(el2_sys_regs_t *regs);
+} el2_grp_desc_t;
+
+static const el2_grp_desc_t el2_grp_descs[CTX_EL2_GRP_COUNT] = {
+	[CTX_EL2_GRP_TRANS] = {
+		el2_sysregs_trans_save, el2_sysregs_trans_restore
+	},
+	[CTX_EL2_GRP_EXCEPT] = {
+		el2_sysregs_except_save, el2_sysregs_except_restore
+	},
+	[CTX_EL2_GRP_THREAD] = {
+		el2_sysregs_thread_save, el2_sysregs_thread_restore
+	},
+	[CTX_EL2_GRP_TIMER] = {
+		el2_sysregs_timer_save, el2_sysregs_timer_restore
+	},
+};
+
+/* EL2 register groups switched by a full save or restore */
+static unsigned int el2_switched_grps = CTX_EL2_GRPS_ALL;
+
+/*******************************************************************************
+ * Select the EL2 register groups that a full save or restore switches between
+ * the worlds. The other groups are shared: both worlds use the values in the
+ * hardware, which is only correct when the secure world leaves them alone.
+ * A dispatcher calls this once its secure payload has declared which groups
+ * it uses, before any world switch relies on the shared values.
+ ******************************************************************************/
+void cm_el2_sysregs_set_switched_grps(unsigned int grps)
+{
+	assert((grps & ~CTX_EL2_GRPS_ALL) == 0U);
+
+	el2_switched_grps = grps;
+}
+
+static void cm_el2_sysregs_switch_grps(el2_sys_regs_t *regs, bool save)
+{
+	unsigned int grp;
+
+	for (grp = 0U; grp < CTX_EL2_GRP_COUNT; grp++) {
+		if ((el2_switched_grps & CTX_EL2_GRP_BIT(grp)) == 0U) {
+			continue;
+		}
+
+		if (save) {
+			el2_grp_descs[grp].save(regs);
+		} else {
+			el2_grp_descs[grp].restore(regs);
+		}
+	}
+}
+
 void cm_el2_sysregs_context_save(uint32_t security_state, uint32_t is_host_only)
 {
 	cpu_context_t *ctx;
@@ -663,7 +877,12 @@ void cm_el2_sysregs_context_save(uint32_t security_state, uint32_t is_host_only)
 	if (is_host_only) { // only save host context
 		el2_sysregs_context_save_host_only(get_el2_sysregs_ctx(ctx));
 	} else { // save all context related to el2
-		el2_sysregs_context_save(get_el2_sysregs_ctx(ctx));
+		if (el2_switched_grps == CTX_EL2_GRPS_ALL) {
+			el2_sysregs_context_save(get_el2_sysregs_ctx(ctx));
+		} else {
+			cm_el2_sysregs_switch_grps(get_el2_sysregs_ctx(ctx),
+						   true);
+		}
 	}
 
 #if IMAGE_BL31
@@ -685,7 +904,12 @@ void cm_el2_sysregs_context_restore(uint32_t security_state, uint32_t is_host_on
     if (is_host_only) { // only save host context
 	    el2_sysregs_context_restore_host_only(get_el2_sysregs_ctx(ctx));
     } else { // save all context related to el2
-	    el2_sysregs_context_restore(get_el2_sysregs_ctx(ctx));
+	    if (el2_switched_grps == CTX_EL2_GRPS_ALL) {
+		    el2_sysregs_context_restore(get_el2_sysregs_ctx(ctx));
+	    } else {
+		    cm_el2_sysregs_switch_grps(get_el2_sysregs_ctx(ctx),
+					       false);
+	    }
     }
 
 #if IMAGE_BL31
@@ -714,6 +938,121 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 #endif
 }
 
+/*******************************************************************************
+ * Queue a write of 'value' to the system register 'id', one of CTX_DEFER_*,
+ * which el3_exit performs the next time it exits to the given security state,
+ * after SCR_EL3 has been programmed. Queueing the same register again before
+ * that replaces the value.
+ ******************************************************************************/
+void cm_defer_sysreg_write(uint32_t security_state, unsigned int id,
+			   u_register_t value)
+{
+	defer_sysregs_t *state;
+	cpu_context_t *ctx;
+
+	assert(id < CTX_DEFER_SYSREG_COUNT);
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	state = get_defer_sysregs_ctx(ctx);
+	write_ctx_reg(state, CTX_DEFER_VALUES + (id << DWORD_SHIFT), value);
+	write_ctx_reg(state, CTX_DEFER_PENDING,
+		      read_ctx_reg(state, CTX_DEFER_PENDING) | (1ULL << id));
+}
+
+#if CTX_INCLUDE_FPREGS
+/*******************************************************************************
+ * Switch the FP/SIMD registers from the other security state to the given one
+ * before entering it. Without CTX_FPREGS_LAZY the registers are saved and
+ * restored right away.
+ *
+ * With CTX_FPREGS_LAZY only CPTR_EL3.TFP is updated: the registers stay with
+ * their current owner and the first access from a world which does not own
+ * them traps to fpregs_lazy_switch, which moves them over. No ISB is needed as
+ * the ERET into the lower EL synchronises the write of CPTR_EL3.
+ ******************************************************************************/
+void cm_fpregs_context_switch(uint32_t security_state)
+{
+	uint32_t other_state = (security_state == SECURE) ? NON_SECURE : SECURE;
+#if CTX_FPREGS_LAZY
+	u_register_t owner = get_cpu_data(cpu_fp_owner);
+	u_register_t cptr = read_cptr_el3();
+
+	/*
+	 * Until the first switch after a cold boot accesses do not trap, so
+	 * the registers belong to the world being left. After a warm boot
+	 * accesses trap and the registers hold no state worth saving.
+	 */
+	if ((owner == CPU_FP_OWNER_NONE) && ((cptr & TFP_BIT) == 0U)) {
+		owner = CPU_FP_OWNER(other_state);
+		set_cpu_data(cpu_fp_owner, owner);
+	}
+
+	if (owner == CPU_FP_OWNER(security_state))
+		cptr &= ~TFP_BIT;
+	else
+		cptr |= TFP_BIT;
+
+	write_cptr_el3(cptr);
+#else
+	fpregs_context_save(get_fpregs_ctx(cm_get_context(other_state)));
+	fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+#endif
+}
+
+#if CTX_FPREGS_LAZY && IMAGE_BL31
+/*******************************************************************************
+ * The FP/SIMD registers are lost when the cpu powers down. Save them to the
+ * context of their owner beforehand, then make the next access from either
+ * world trap so that it reloads its saved registers.
+ *
+ * Accesses only do not trap without an owner before the first world switch
+ * after a cold boot, as in cm_fpregs_context_switch(). The registers then
+ * belong to the world which requested the power down, which SCR_EL3 still
+ * refers to.
+ ******************************************************************************/
+static void *cm_fpregs_flush(const void *arg)
+{
+	u_register_t owner = get_cpu_data(cpu_fp_owner);
+
+	if ((owner == CPU_FP_OWNER_NONE) &&
+	    ((read_cptr_el3() & TFP_BIT) == 0U)) {
+		owner = ((read_scr_el3() & SCR_NS_BIT) != 0U) ?
+			CPU_FP_OWNER(NON_SECURE) : CPU_FP_OWNER(SECURE);
+	}
+
+	if (owner != CPU_FP_OWNER_NONE) {
+		write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+		isb();
+		fpregs_context_save(get_fpregs_ctx(cm_get_context(
+			(uint32_t)owner - 1U)));
+	}
+
+	set_cpu_data(cpu_fp_owner, CPU_FP_OWNER_NONE);
+	write_cptr_el3(read_cptr_el3() | TFP_BIT);
+
+	return (void *)0;
+}
+
+/*******************************************************************************
+ * CPTR_EL3 has been reinitialised on warm boot and the FP/SIMD registers hold
+ * no saved state.
+ ******************************************************************************/
+static void *cm_fpregs_warmboot_init(const void *arg)
+{
+	set_cpu_data(cpu_fp_owner, CPU_FP_OWNER_NONE);
+	write_cptr_el3(read_cptr_el3() | TFP_BIT);
+
+	return (void *)0;
+}
+
+SUBSCRIBE_TO_EVENT(psci_suspend_pwrdown_start, cm_fpregs_flush);
+SUBSCRIBE_TO_EVENT(psci_suspend_pwrdown_finish, cm_fpregs_warmboot_init);
+SUBSCRIBE_TO_EVENT(psci_cpu_on_finish, cm_fpregs_warmboot_init);
+#endif /* CTX_FPREGS_LAZY && IMAGE_BL31 */
+#endif /* CTX_INCLUDE_FPREGS */
+
 /*******************************************************************************
  * This function populates ELR_EL3 member of 'cpu_context' pertaining to the
  * given security state with the given entrypoint
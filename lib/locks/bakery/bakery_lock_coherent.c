@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* This file implements the functions the lock profiler wraps */
+#define LOCK_PROF_NO_WRAPPERS
+
 #include <assert.h>
 #include <string.h>
 
@@ -166,3 +169,18 @@ void bakery_lock_release(bakery_lock_t *bakery)
 	dsb();
 	sev();
 }
+
+#if LOCK_PROFILING
+/* Tell the lock profiler whether any CPU holds or waits for the lock */
+bool bakery_lock_is_busy(bakery_lock_t *bakery)
+{
+	unsigned int they;
+
+	for (they = 0U; they < BAKERY_LOCK_MAX_CPUS; they++) {
+		if (bakery->lock_data[they] != 0U)
+			return true;
+	}
+
+	return false;
+}
+#endif
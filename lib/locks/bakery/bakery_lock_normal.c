@@ -5,6 +5,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* This file implements the functions the lock profiler wraps */
+#define LOCK_PROF_NO_WRAPPERS
+
 #include <assert.h>
 #include <string.h>
 
@@ -248,3 +251,22 @@ void bakery_lock_release(bakery_lock_t *lock)
 	/* This sev is ordered by the dsbish in write_cahce_op */
 	sev();
 }
+
+#if LOCK_PROFILING
+/* Tell the lock profiler whether any CPU holds or waits for the lock */
+bool bakery_lock_is_busy(bakery_lock_t *lock)
+{
+	bakery_info_t *their_bakery_info;
+	bool is_cached = is_dcache_enabled();
+	unsigned int they;
+
+	for (they = 0U; they < BAKERY_LOCK_MAX_CPUS; they++) {
+		their_bakery_info = get_bakery_info(they, lock);
+		read_cache_op((uintptr_t)their_bakery_info, is_cached);
+		if (their_bakery_info->lock_data != 0U)
+			return true;
+	}
+
+	return false;
+}
+#endif
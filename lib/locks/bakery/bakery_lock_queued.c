@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* This file implements the functions the lock profiler wraps */
+#define LOCK_PROF_NO_WRAPPERS
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <lib/bakery_lock.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+
+/*
+ * Functions in this file implement MCS queued locks behind the bakery lock
+ * interface, for systems where all contenders are cache coherent. They use the
+ * layout of bakery_lock_normal.c: every CPU has its own copy of each lock in a
+ * cache line it alone waits on, which here is its node in the queue of the
+ * lock. The lock word itself is the tail of the queue, kept in the copy of
+ * CPU 0.
+ *
+ * A CPU joins the queue with a single atomic exchange of the tail and then
+ * waits on its own node until its predecessor hands the lock over, so the cost
+ * of an acquisition does not depend on the number of CPUs and a release only
+ * wakes up the next CPU in line.
+ */
+
+#if !HW_ASSISTED_COHERENCY
+#error "QUEUED_LOCKS requires HW_ASSISTED_COHERENCY"
+#endif
+
+#ifdef PLAT_PERCPU_BAKERY_LOCK_SIZE
+CASSERT((PLAT_PERCPU_BAKERY_LOCK_SIZE & (CACHE_WRITEBACK_GRANULE - 1)) == 0, \
+	PLAT_PERCPU_BAKERY_LOCK_SIZE_not_cacheline_multiple);
+#define PERCPU_BAKERY_LOCK_SIZE (PLAT_PERCPU_BAKERY_LOCK_SIZE)
+#else
+IMPORT_SYM(uintptr_t, __PERCPU_BAKERY_LOCK_START__, BAKERY_LOCK_START);
+IMPORT_SYM(uintptr_t, __PERCPU_BAKERY_LOCK_END__, BAKERY_LOCK_END);
+#define PERCPU_BAKERY_LOCK_SIZE (BAKERY_LOCK_END - BAKERY_LOCK_START)
+#endif
+
+static inline bakery_info_t *get_bakery_info(unsigned int cpu_ix,
+					     bakery_lock_t *lock)
+{
+	return (bakery_info_t *)((uintptr_t)lock +
+				cpu_ix * PERCPU_BAKERY_LOCK_SIZE);
+}
+
+void bakery_lock_get(bakery_lock_t *lock)
+{
+	unsigned int me = plat_my_core_pos();
+	bakery_info_t *my_node = get_bakery_info(me, lock);
+	uint32_t prev;
+
+	/* Prevent recursive acquisition */
+	assert(lock->tail != (me + 1U));
+
+	my_node->next = 0U;
+	my_node->wait = 1U;
+
+	/* Join the queue, publishing the initialised node */
+	prev = __atomic_exchange_n(&lock->tail, me + 1U, __ATOMIC_ACQ_REL);
+	if (prev == 0U)
+		return;
+
+	/* Link behind the predecessor and wait for it to hand the lock over */
+	__atomic_store_n(&get_bakery_info(prev - 1U, lock)->next,
+			 (uint16_t)(me + 1U), __ATOMIC_RELEASE);
+
+	while (__atomic_load_n(&my_node->wait, __ATOMIC_ACQUIRE) != 0U)
+		wfe();
+}
+
+void bakery_lock_release(bakery_lock_t *lock)
+{
+	unsigned int me = plat_my_core_pos();
+	bakery_info_t *my_node = get_bakery_info(me, lock);
+	uint32_t expected = me + 1U;
+	unsigned int next;
+
+	next = __atomic_load_n(&my_node->next, __ATOMIC_ACQUIRE);
+	if (next == 0U) {
+		/* Free the lock unless a CPU is joining the queue */
+		if (__atomic_compare_exchange_n(&lock->tail, &expected, 0U,
+						false, __ATOMIC_RELEASE,
+						__ATOMIC_RELAXED))
+			return;
+
+		/* Wait for it to link behind this CPU */
+		do {
+			next = __atomic_load_n(&my_node->next,
+					       __ATOMIC_ACQUIRE);
+		} while (next == 0U);
+	}
+
+	/*
+	 * Hand the lock over. The release store orders the critical section
+	 * before it, and the sev is ordered after it by the dsbish.
+	 */
+	__atomic_store_n(&get_bakery_info(next - 1U, lock)->wait, 0U,
+			 __ATOMIC_RELEASE);
+	dsbish();
+	sev();
+}
+
+#if LOCK_PROFILING
+/* Tell the lock profiler whether any CPU holds or waits for the lock */
+bool bakery_lock_is_busy(bakery_lock_t *lock)
+{
+	return __atomic_load_n(&lock->tail, __ATOMIC_RELAXED) != 0U;
+}
+#endif
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*******************************************************************************
+ * Lock profiling. The C callers of spin_lock()/spin_unlock() and of
+ * bakery_lock_get()/bakery_lock_release() in BL31 are routed here by
+ * spinlock.h and bakery_lock.h. For every lock registered with
+ * REGISTER_LOCK_PROF(), the wrappers count the acquisitions and those which
+ * found the lock busy, and measure the time spent waiting for and holding the
+ * lock in ticks of the system counter, along with the call sites of the
+ * longest wait and hold. Other locks are passed through.
+ *
+ * The statistics of a lock are only written by its owner. Nothing is recorded
+ * while the data cache of the calling CPU is off, as its writes would not be
+ * coherent with the other CPUs: the hold time of a lock released on the way
+ * to a power down is lost.
+ ******************************************************************************/
+
+/* This file implements the functions the lock profiler wraps */
+#define LOCK_PROF_NO_WRAPPERS
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/bl_common.h>
+#include <common/runtime_svc.h>
+#include <lib/bakery_lock.h>
+#include <lib/lock_prof.h>
+#include <lib/smccc.h>
+#include <lib/spinlock.h>
+
+IMPORT_SYM(uintptr_t, __LOCK_PROF_DESCS_START__,	LOCK_PROF_DESCS_START);
+IMPORT_SYM(uintptr_t, __LOCK_PROF_DESCS_END__,		LOCK_PROF_DESCS_END);
+
+#define LOCK_PROF_DESCS		((const lock_prof_desc_t *)LOCK_PROF_DESCS_START)
+#define LOCK_PROF_NUM_DESCS	((LOCK_PROF_DESCS_END - LOCK_PROF_DESCS_START) \
+				 / sizeof(lock_prof_desc_t))
+
+static lock_prof_stats_t *lock_prof_lookup(const void *lock)
+{
+	const lock_prof_desc_t *desc;
+	uintptr_t addr = (uintptr_t)lock;
+	size_t off;
+	unsigned int i;
+
+	for (i = 0U; i < LOCK_PROF_NUM_DESCS; i++) {
+		desc = &LOCK_PROF_DESCS[i];
+		if (addr < desc->base)
+			continue;
+
+		off = addr - desc->base;
+		if ((off / desc->stride) < desc->num)
+			return &desc->stats[off / desc->stride];
+	}
+
+	return NULL;
+}
+
+/* Return the statistics of the lock at index 'idx' of all profiled locks */
+static lock_prof_stats_t *lock_prof_index(u_register_t idx, uintptr_t *lock)
+{
+	const lock_prof_desc_t *desc;
+	unsigned int i;
+
+	for (i = 0U; i < LOCK_PROF_NUM_DESCS; i++) {
+		desc = &LOCK_PROF_DESCS[i];
+		if (idx < desc->num) {
+			*lock = desc->base + (idx * desc->stride);
+			return &desc->stats[idx];
+		}
+
+		idx -= desc->num;
+	}
+
+	return NULL;
+}
+
+static void lock_prof_acquired(lock_prof_stats_t *stats, bool busy,
+			       uint64_t start, uintptr_t pc)
+{
+	uint64_t now = read_cntpct_el0();
+	uint64_t wait = now - start;
+
+	stats->acquires++;
+	if (busy)
+		stats->contended++;
+
+	stats->wait_ticks += wait;
+	if (wait > stats->max_wait_ticks) {
+		stats->max_wait_ticks = wait;
+		stats->max_wait_pc = pc;
+	}
+
+	/* 0 means free, which the counter cannot read this late */
+	stats->acquired_at = now;
+	stats->acquired_pc = pc;
+}
+
+static void lock_prof_releasing(lock_prof_stats_t *stats)
+{
+	uint64_t hold;
+
+	if (stats->acquired_at == 0U)
+		return;
+
+	hold = read_cntpct_el0() - stats->acquired_at;
+	if (hold > stats->max_hold_ticks) {
+		stats->max_hold_ticks = hold;
+		stats->max_hold_pc = stats->acquired_pc;
+	}
+
+	stats->acquired_at = 0U;
+}
+
+static bool spin_lock_is_busy(const spinlock_t *lock)
+{
+	uint32_t val = lock->lock;
+
+#if QUEUED_LOCKS
+	/* The next ticket is in the top half, the owner's in the bottom one */
+	return (val >> 16) != (val & 0xffffU);
+#else
+	return val != 0U;
+#endif
+}
+
+void lock_prof_spin_lock(spinlock_t *lock)
+{
+	lock_prof_stats_t *stats = lock_prof_lookup(lock);
+	uint64_t start;
+	bool busy;
+
+	if ((stats == NULL) || !is_dcache_enabled()) {
+		spin_lock(lock);
+		return;
+	}
+
+	start = read_cntpct_el0();
+	busy = spin_lock_is_busy(lock);
+	spin_lock(lock);
+	lock_prof_acquired(stats, busy, start,
+			   (uintptr_t)__builtin_return_address(0));
+}
+
+void lock_prof_spin_unlock(spinlock_t *lock)
+{
+	lock_prof_stats_t *stats = lock_prof_lookup(lock);
+
+	if ((stats != NULL) && is_dcache_enabled())
+		lock_prof_releasing(stats);
+
+	spin_unlock(lock);
+}
+
+void lock_prof_bakery_lock_get(bakery_lock_t *bakery)
+{
+	lock_prof_stats_t *stats = lock_prof_lookup(bakery);
+	uint64_t start;
+	bool busy;
+
+	if ((stats == NULL) || !is_dcache_enabled()) {
+		bakery_lock_get(bakery);
+		return;
+	}
+
+	start = read_cntpct_el0();
+	busy = bakery_lock_is_busy(bakery);
+	bakery_lock_get(bakery);
+	lock_prof_acquired(stats, busy, start,
+			   (uintptr_t)__builtin_return_address(0));
+}
+
+void lock_prof_bakery_lock_release(bakery_lock_t *bakery)
+{
+	lock_prof_stats_t *stats = lock_prof_lookup(bakery);
+
+	if ((stats != NULL) && is_dcache_enabled())
+		lock_prof_releasing(stats);
+
+	bakery_lock_release(bakery);
+}
+
+/*******************************************************************************
+ * Handle the SiP call reading the lock profiling data, see lock_prof.h.
+ ******************************************************************************/
+uintptr_t lock_prof_smc_handler(unsigned int smc_fid,
+				u_register_t cmd,
+				u_register_t x2,
+				u_register_t x3,
+				u_register_t x4,
+				void *cookie,
+				void *handle,
+				u_register_t flags)
+{
+	const lock_prof_desc_t *desc;
+	const lock_prof_stats_t *stats;
+	uintptr_t lock = 0U;
+	u_register_t num = 0U;
+	unsigned int i;
+
+#if !DEBUG
+	/* The lock addresses and call sites reveal the layout of BL31 */
+	if (!is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+#endif
+
+	switch (cmd) {
+	case LOCK_PROF_INFO:
+		for (i = 0U; i < LOCK_PROF_NUM_DESCS; i++)
+			num += LOCK_PROF_DESCS[i].num;
+
+		SMC_RET3(handle, SMC_OK, num, read_cntfrq_el0());
+
+	case LOCK_PROF_LOCK:
+		stats = lock_prof_index(x2, &lock);
+		if (stats == NULL)
+			break;
+
+		SMC_RET7(handle, SMC_OK, lock, stats->acquires,
+			 stats->contended, stats->wait_ticks,
+			 stats->max_wait_ticks, stats->max_hold_ticks);
+
+	case LOCK_PROF_PCS:
+		stats = lock_prof_index(x2, &lock);
+		if (stats == NULL)
+			break;
+
+		SMC_RET3(handle, SMC_OK, stats->max_wait_pc,
+			 stats->max_hold_pc);
+
+	case LOCK_PROF_RESET:
+		/*
+		 * Keep the acquisitions in progress, so that their hold time
+		 * is still measured. An update made by an owner at the same
+		 * time may survive.
+		 */
+		for (i = 0U; i < LOCK_PROF_NUM_DESCS; i++) {
+			desc = &LOCK_PROF_DESCS[i];
+			for (num = 0U; num < desc->num; num++) {
+				desc->stats[num].acquires = 0U;
+				desc->stats[num].contended = 0U;
+				desc->stats[num].wait_ticks = 0U;
+				desc->stats[num].max_wait_ticks = 0U;
+				desc->stats[num].max_hold_ticks = 0U;
+				desc->stats[num].max_wait_pc = 0U;
+				desc->stats[num].max_hold_pc = 0U;
+			}
+		}
+
+		SMC_RET1(handle, SMC_OK);
+
+	default:
+		break;
+	}
+
+	SMC_RET1(handle, SMC_UNK);
+}
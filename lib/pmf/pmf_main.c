@@ -12,6 +12,7 @@
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include <lib/pmf/pmf.h>
+#include <lib/psci/psci_cmo.h>
 #include <lib/utils_def.h>
 #include <plat/common/platform.h>
 
@@ -30,6 +31,10 @@ IMPORT_SYM(uintptr_t, __PMF_SVC_DESCS_END__,		PMF_SVC_DESCS_END);
 IMPORT_SYM(uintptr_t, __PMF_PERCPU_TIMESTAMP_END__,	PMF_PERCPU_TIMESTAMP_END);
 IMPORT_SYM(uintptr_t,  __PMF_TIMESTAMP_START__,		PMF_TIMESTAMP_ARRAY_START);
 
+/* The timestamps of each CPU follow those of the previous one */
+REGISTER_PSCI_CMO_REGION(pmf_timestamps, __PMF_TIMESTAMP_START__,
+			 __PMF_PERCPU_TIMESTAMP_END__, PSCI_CMO_STRIDE_SLICE);
+
 #define PMF_PERCPU_TIMESTAMP_SIZE	(PMF_PERCPU_TIMESTAMP_END - PMF_TIMESTAMP_ARRAY_START)
 
 #define PMF_SVC_DESCS_MAX		10
@@ -14,6 +14,8 @@
 #include <context.h>
 #include <drivers/delay_timer.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/lock_prof.h>
+#include <lib/psci/psci_cmo.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 
@@ -58,11 +60,32 @@ non_cpu_pd_node_t psci_non_cpu_pd_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 __section("tzfw_coherent_mem")
 #endif
 ;
+REGISTER_PSCI_CMO_ARRAY(psci_non_cpu_pd_nodes);
 
 /* Lock for PSCI state coordination */
 DEFINE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
+REGISTER_LOCK_PROF_ARRAY(psci_locks);
 
 cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
+REGISTER_PSCI_CMO_PERCPU_ARRAY(psci_cpu_pd_nodes);
+
+#if PSCI_LOCKFREE_COORD
+/*
+ * Coordination word of every non-CPU power domain which is the parent of CPU
+ * power domains. It holds the number of its cpus which request the RUN state
+ * for it, and a flag set while the last of them powers it down or the first
+ * of them powers it up. Only these two cpus take the locks of the power
+ * domain tree, see psci_coord_pwr_down() and psci_coord_pwr_up(). Each word
+ * has a cache line of its own.
+ */
+#define PSCI_COORD_BUSY			U(0x80000000)
+
+typedef struct psci_coord {
+	unsigned int word;
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_coord_t;
+
+static psci_coord_t psci_coord[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+#endif
 
 /*******************************************************************************
  * Pointer to functions exported by the platform to complete power mgmt. ops
@@ -608,6 +631,133 @@ void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
 	}
 }
 
+#if PSCI_LOCKFREE_COORD
+/*******************************************************************************
+ * This function records that the calling cpu is the only one running, for use
+ * by the primary cpu at cold boot.
+ ******************************************************************************/
+void __init psci_coord_init(void)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+
+	if (PLAT_MAX_PWR_LVL > PSCI_CPU_PWR_LVL)
+		psci_coord[psci_cpu_pd_nodes[cpu_idx].parent_node].word = 1U;
+}
+
+/*******************************************************************************
+ * This function adds one to the number of running cpus of the power domain
+ * 'parent_idx' if 'up' is set, otherwise it removes one. It waits for the
+ * first or last cpu of the domain to complete its transition, and returns 1 if
+ * the calling cpu becomes the one starting a transition.
+ ******************************************************************************/
+static unsigned int psci_coord_update(unsigned int parent_idx, unsigned int up)
+{
+	volatile unsigned int *word = &psci_coord[parent_idx].word;
+	unsigned int old, new;
+
+	for (;;) {
+		old = *word;
+		if ((old & PSCI_COORD_BUSY) != 0U)
+			continue;
+
+		if (up != 0U) {
+			new = (old == 0U) ? (PSCI_COORD_BUSY | 1U) : (old + 1U);
+		} else {
+			assert(old != 0U);
+			new = (old == 1U) ? PSCI_COORD_BUSY : (old - 1U);
+		}
+
+		if (psci_coord_cas((unsigned int *)word, old, new) == old)
+			return ((new & PSCI_COORD_BUSY) != 0U) ? 1U : 0U;
+	}
+}
+
+/*******************************************************************************
+ * Replacement of the acquisition of the locks and psci_do_state_coordination()
+ * for a cpu powering down to 'end_pwrlvl'. The cpu publishes its requested
+ * states and leaves the running cpus of its parent domain. If others remain,
+ * that domain and its ancestors stay in the RUN state whatever the states it
+ * requested, so 'state_info' is updated accordingly without taking any lock.
+ * Otherwise the cpu acquires the locks and coordinates the states as usual.
+ *
+ * Returns 1 if the cpu acquired the locks. In either case the caller must call
+ * psci_coord_release() once it is done with the power domain tree.
+ ******************************************************************************/
+unsigned int psci_coord_pwr_down(unsigned int end_pwrlvl,
+				 const unsigned int *parent_nodes,
+				 psci_power_state_t *state_info)
+{
+	unsigned int lvl, cpu_idx = plat_my_core_pos();
+
+	if (end_pwrlvl == PSCI_CPU_PWR_LVL) {
+		psci_do_state_coordination(end_pwrlvl, state_info);
+		return 0U;
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     state_info->pwr_domain_state[lvl]);
+
+	if (psci_coord_update(parent_nodes[0], 0U) != 0U) {
+		psci_acquire_pwr_domain_locks(end_pwrlvl, parent_nodes);
+		psci_do_state_coordination(end_pwrlvl, state_info);
+		return 1U;
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
+
+	psci_set_cpu_local_state(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
+
+	return 0U;
+}
+
+/*******************************************************************************
+ * Replacement of the acquisition of the locks for a cpu powering up from
+ * 'end_pwrlvl'. The cpu joins the running cpus of its parent domain, and only
+ * acquires the locks if it is the first one. The others find the domain and its
+ * ancestors in the RUN state, which they do not change.
+ *
+ * Returns 1 if the cpu acquired the locks. The caller must call
+ * psci_coord_release() once it is done with the power domain tree.
+ ******************************************************************************/
+unsigned int psci_coord_pwr_up(unsigned int end_pwrlvl,
+			       const unsigned int *parent_nodes)
+{
+	if (end_pwrlvl == PSCI_CPU_PWR_LVL)
+		return 0U;
+
+	if (psci_coord_update(parent_nodes[0], 1U) == 0U)
+		return 0U;
+
+	psci_acquire_pwr_domain_locks(end_pwrlvl, parent_nodes);
+
+	return 1U;
+}
+
+/*******************************************************************************
+ * This function releases the locks acquired by psci_coord_pwr_down() or
+ * psci_coord_pwr_up() if 'locked' is set, and lets the other cpus of the
+ * parent domain through.
+ ******************************************************************************/
+void psci_coord_release(unsigned int end_pwrlvl,
+			const unsigned int *parent_nodes,
+			unsigned int locked)
+{
+	unsigned int *word;
+
+	if (locked == 0U)
+		return;
+
+	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
+
+	/* Nothing else updates the word while it is busy */
+	word = &psci_coord[parent_nodes[0]].word;
+	(void)psci_coord_cas(word, *word, *word & ~PSCI_COORD_BUSY);
+}
+#endif /* PSCI_LOCKFREE_COORD */
+
 /*******************************************************************************
  * Simple routine to determine whether a mpidr is valid or not.
  ******************************************************************************/
@@ -772,6 +922,9 @@ void psci_warmboot_entrypoint(void)
 	unsigned int cpu_idx = plat_my_core_pos();
 	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
+#if PSCI_LOCKFREE_COORD
+	unsigned int locked;
+#endif
 
 	/*
 	 * Verify that we have been explicitly turned ON or resumed from
@@ -796,7 +949,11 @@ void psci_warmboot_entrypoint(void)
 	 * that by the time all locks are taken, the system topology is snapshot
 	 * and state management can be done safely.
 	 */
+#if PSCI_LOCKFREE_COORD
+	locked = psci_coord_pwr_up(end_pwrlvl, parent_nodes);
+#else
 	psci_acquire_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 
 	psci_get_target_local_pwr_states(end_pwrlvl, &state_info);
 
@@ -841,7 +998,11 @@ void psci_warmboot_entrypoint(void)
 	 * This loop releases the lock corresponding to each power level
 	 * in the reverse order to which they were acquired.
 	 */
+#if PSCI_LOCKFREE_COORD
+	psci_coord_release(end_pwrlvl, parent_nodes, locked);
+#else
 	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 }
 
 /*******************************************************************************
@@ -950,6 +1111,32 @@ int psci_secondaries_brought_up(void)
 	return (n_valid > 1U) ? 1 : 0;
 }
 
+#if PSCI_TARGETED_CMO
+IMPORT_SYM(uintptr_t, __PSCI_CMO_REGIONS_START__,	PSCI_CMO_REGIONS_START);
+IMPORT_SYM(uintptr_t, __PSCI_CMO_REGIONS_END__,		PSCI_CMO_REGIONS_END);
+
+/*******************************************************************************
+ * Write back the EL3 data registered with REGISTER_PSCI_CMO_REGION() which this
+ * CPU may have dirtied, i.e. the shared regions and its own per-CPU regions,
+ * by VA. The data cache stays enabled.
+ ******************************************************************************/
+static void psci_do_pwrdown_targeted_cmo(void)
+{
+	const psci_cmo_region_t *region;
+	unsigned int cpu_idx = plat_my_core_pos();
+	size_t size, stride;
+
+	for (region = (const psci_cmo_region_t *)PSCI_CMO_REGIONS_START;
+	     region < (const psci_cmo_region_t *)PSCI_CMO_REGIONS_END;
+	     region++) {
+		size = region->end - region->base;
+		stride = (region->stride == PSCI_CMO_STRIDE_SLICE) ?
+			size : region->stride;
+		clean_dcache_range(region->base + (cpu_idx * stride), size);
+	}
+}
+#endif /* PSCI_TARGETED_CMO */
+
 /*******************************************************************************
  * Initiate power down sequence, by calling power down operations registered for
  * this CPU.
@@ -964,6 +1151,23 @@ void psci_do_pwrdown_sequence(unsigned int power_level)
 	 */
 	prepare_cpu_pwr_dwn(power_level);
 #else
+#if PSCI_TARGETED_CMO
+	/*
+	 * If the power controller writes back and invalidates the caches of
+	 * this CPU and takes it out of coherency when it powers down to
+	 * `power_level`, only the EL3 data other CPUs may read from memory
+	 * before that needs to be cleaned. The CPU driver then initiates the
+	 * power down sequence with its handler which leaves the caches alone,
+	 * so the set/way maintenance is skipped and the data cache stays
+	 * enabled. CPUs without such a handler take the usual path.
+	 */
+	if (plat_psci_pwrdown_hw_cache_clean(power_level) &&
+	    cpu_has_pwr_dwn_noflush()) {
+		psci_do_pwrdown_targeted_cmo();
+		prepare_cpu_pwr_dwn_noflush(power_level);
+		return;
+	}
+#endif
 	/*
 	 * Without hardware-assisted coherency, the CPU drivers disable data
 	 * caches, then perform cache-maintenance operations in software.
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <common/runtime_svc.h>
+#include <lib/psci/psci_idle_policy.h>
+#include <lib/smccc.h>
+#include <plat/common/platform.h>
+
+#include "psci_private.h"
+
+/*
+ * The idle state policy adjusts the power domain levels entered by
+ * CPU_SUSPEND from the length of the last idle periods of the calling CPU, as
+ * measured by the PSCI statistics, and the target residency the platform
+ * returns for every local power state:
+ *
+ * - A power domain level whose requested state mostly does not pay off is
+ *   demoted to RUN, so that its cache maintenance and wakeup latency are
+ *   saved.
+ * - When the CPU powers down up to a level and its idle periods all exceeded
+ *   the target residency of the OFF state of the next level, that level is
+ *   promoted to OFF, up to the level set by the normal world.
+ *
+ * Only the levels above the CPU level are adjusted, as the shallower states
+ * of a CPU are platform specific. Promotion only considers the levels whose
+ * OFF state has a target residency, which the platform thereby declares as
+ * supported.
+ */
+typedef struct psci_idle_cpu {
+	/* Last idle periods in microseconds, oldest first once full */
+	uint32_t history[PSCI_IDLE_POLICY_HISTORY];
+	unsigned int next;
+	unsigned int num;
+
+	/* Bounds set by the normal world */
+	unsigned int max_promote_lvl;
+	bool demote;
+
+	u_register_t demotions;
+	u_register_t promotions;
+} psci_idle_cpu_t;
+
+static psci_idle_cpu_t psci_idle_cpus[PLATFORM_CORE_COUNT] = {
+	[0 ... PLATFORM_CORE_COUNT - 1U] = {
+		.max_promote_lvl = PSCI_CPU_PWR_LVL,
+		.demote = true
+	}
+};
+
+/* Return the number of idle periods of `idle` shorter than `target` */
+static unsigned int psci_idle_num_shorter(const psci_idle_cpu_t *idle,
+					  u_register_t target)
+{
+	unsigned int i, num = 0U;
+
+	for (i = 0U; i < idle->num; i++) {
+		if (idle->history[i] < target)
+			num++;
+	}
+
+	return num;
+}
+
+/*******************************************************************************
+ * This function records an idle period of `residency` microseconds of the CPU
+ * `cpu_idx`. It is called on the CPU, with caches enabled, when it resumes
+ * from CPU_SUSPEND.
+ ******************************************************************************/
+void psci_idle_policy_record(unsigned int cpu_idx, u_register_t residency)
+{
+	psci_idle_cpu_t *idle = &psci_idle_cpus[cpu_idx];
+
+	idle->history[idle->next] = (residency > UINT32_MAX) ?
+		UINT32_MAX : (uint32_t)residency;
+	idle->next = (idle->next + 1U) % PSCI_IDLE_POLICY_HISTORY;
+	if (idle->num < PSCI_IDLE_POLICY_HISTORY)
+		idle->num++;
+}
+
+/*******************************************************************************
+ * This function adjusts the local power states in `state_info` of a valid
+ * CPU_SUSPEND request of the current CPU, see above. It returns true if any
+ * state was changed.
+ ******************************************************************************/
+bool psci_idle_policy_apply(psci_power_state_t *state_info,
+			    unsigned int is_power_down_state)
+{
+	psci_idle_cpu_t *idle = &psci_idle_cpus[plat_my_core_pos()];
+	unsigned int lvl, target_lvl;
+	plat_local_state_t state;
+	u_register_t target;
+	bool changed = false;
+
+	/* Wait for a full history before acting on it */
+	if (idle->num < PSCI_IDLE_POLICY_HISTORY)
+		return false;
+
+	target_lvl = psci_find_target_suspend_lvl(state_info);
+	assert(target_lvl != PSCI_INVALID_PWR_LVL);
+
+	/* Demote the levels, from the highest, while they do not pay off */
+	for (lvl = target_lvl; idle->demote && (lvl > PSCI_CPU_PWR_LVL);
+	     lvl--) {
+		state = state_info->pwr_domain_state[lvl];
+		target = plat_psci_stat_get_target_residency(lvl, state);
+		if (psci_idle_num_shorter(idle, target) <=
+		    (PSCI_IDLE_POLICY_HISTORY / 2U))
+			break;
+
+		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
+		changed = true;
+	}
+
+	if (changed) {
+		idle->demotions++;
+		return true;
+	}
+
+	/*
+	 * Promote the levels above, while they pay off, if all the levels up
+	 * to the target are powered down.
+	 */
+	if ((is_power_down_state == 0U) ||
+	    (psci_find_max_off_lvl(state_info) != target_lvl))
+		return false;
+
+	for (lvl = target_lvl + 1U; lvl <= idle->max_promote_lvl; lvl++) {
+		target = plat_psci_stat_get_target_residency(lvl,
+							     PLAT_MAX_OFF_STATE);
+		if ((target == 0U) || (psci_idle_num_shorter(idle, target) != 0U))
+			break;
+
+		state_info->pwr_domain_state[lvl] = PLAT_MAX_OFF_STATE;
+		changed = true;
+	}
+
+	if (changed)
+		idle->promotions++;
+
+	return changed;
+}
+
+/*******************************************************************************
+ * Handle the SiP call setting the bounds of the idle state policy, see
+ * psci_idle_policy.h.
+ ******************************************************************************/
+uintptr_t psci_idle_policy_smc_handler(unsigned int smc_fid,
+				       u_register_t cmd,
+				       u_register_t x2,
+				       u_register_t x3,
+				       u_register_t x4,
+				       void *cookie,
+				       void *handle,
+				       u_register_t flags)
+{
+	psci_idle_cpu_t *idle;
+	int core_pos;
+
+	core_pos = plat_core_pos_by_mpidr(x2);
+	if (core_pos < 0)
+		SMC_RET1(handle, PSCI_IDLE_POLICY_E_INVALID_PARAMS);
+
+	idle = &psci_idle_cpus[core_pos];
+
+	switch (cmd) {
+	case PSCI_IDLE_POLICY_SET:
+		if ((x3 > PLAT_MAX_PWR_LVL) || (x4 > 1U))
+			SMC_RET1(handle, PSCI_IDLE_POLICY_E_INVALID_PARAMS);
+
+		idle->max_promote_lvl = (unsigned int)x3;
+		idle->demote = (x4 != 0U);
+		SMC_RET1(handle, SMC_OK);
+
+	case PSCI_IDLE_POLICY_GET:
+		SMC_RET5(handle, SMC_OK, idle->max_promote_lvl,
+			 idle->demote ? 1U : 0U, idle->demotions,
+			 idle->promotions);
+
+	default:
+		break;
+	}
+
+	SMC_RET1(handle, SMC_UNK);
+}
@@ -26,6 +26,8 @@ endif
 
 ifeq (${USE_COHERENT_MEM}, 1)
 PSCI_LIB_SOURCES		+=	lib/locks/bakery/bakery_lock_coherent.c
+else ifeq (${QUEUED_LOCKS}, 1)
+PSCI_LIB_SOURCES		+=	lib/locks/bakery/bakery_lock_queued.c
 else
 PSCI_LIB_SOURCES		+=	lib/locks/bakery/bakery_lock_normal.c
 endif
@@ -33,3 +35,7 @@ endif
 ifeq (${ENABLE_PSCI_STAT}, 1)
 PSCI_LIB_SOURCES		+=	lib/psci/psci_stat.c
 endif
+
+ifeq (${PSCI_IDLE_POLICY}, 1)
+PSCI_LIB_SOURCES		+=	lib/psci/psci_idle_policy.c
+endif
@@ -73,6 +73,14 @@ int psci_cpu_suspend(unsigned int power_state,
 	 */
 	is_power_down_state = psci_get_pstate_type(power_state);
 
+#if PSCI_IDLE_POLICY
+	/*
+	 * Let the idle state policy adjust the power domain levels to suspend
+	 * from the past idle periods of this cpu.
+	 */
+	(void)psci_idle_policy_apply(&state_info, is_power_down_state);
+#endif
+
 	/* Sanity check the requested suspend levels */
 	assert(psci_validate_suspend_req(&state_info, is_power_down_state)
 			== PSCI_E_SUCCESS);
@@ -543,3 +551,34 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 
 	return ret;
 }
+
+/*******************************************************************************
+ * PSCI CPU_SUSPEND handler for the callers which dispatch this high frequency
+ * call on its own rather than through psci_smc_handler().
+ ******************************************************************************/
+u_register_t psci_cpu_suspend_smc_handler(uint32_t smc_fid,
+			  u_register_t x1,
+			  u_register_t x2,
+			  u_register_t x3,
+			  u_register_t x4,
+			  void *cookie,
+			  void *handle,
+			  u_register_t flags)
+{
+	assert((smc_fid == PSCI_CPU_SUSPEND_AARCH32) ||
+	       (smc_fid == PSCI_CPU_SUSPEND_AARCH64));
+
+	if (is_caller_secure(flags))
+		return (u_register_t)SMC_UNK;
+
+	if ((psci_caps & define_psci_cap(smc_fid)) == 0U)
+		return (u_register_t)SMC_UNK;
+
+	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
+		return (u_register_t)psci_cpu_suspend((uint32_t)x1,
+						      (uint32_t)x2,
+						      (uint32_t)x3);
+	}
+
+	return (u_register_t)psci_cpu_suspend((unsigned int)x1, x2, x3);
+}
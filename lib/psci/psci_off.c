@@ -46,6 +46,9 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	unsigned int idx = plat_my_core_pos();
 	psci_power_state_t state_info;
 	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
+#if PSCI_LOCKFREE_COORD
+	unsigned int locked = 0U;
+#endif
 
 	/*
 	 * This function must only be called on platforms where the
@@ -65,12 +68,14 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	 */
 	psci_get_parent_pwr_domain_nodes(idx, end_pwrlvl, parent_nodes);
 
+#if !PSCI_LOCKFREE_COORD
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
 	 * is snapshot and state management can be done safely.
 	 */
 	psci_acquire_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 
 	/*
 	 * Call the cpu off handler registered by the Secure Payload Dispatcher
@@ -88,7 +93,11 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	 * it returns the negotiated state info for each power level upto
 	 * the end level specified.
 	 */
+#if PSCI_LOCKFREE_COORD
+	locked = psci_coord_pwr_down(end_pwrlvl, parent_nodes, &state_info);
+#else
 	psci_do_state_coordination(end_pwrlvl, &state_info);
+#endif
 
 #if ENABLE_PSCI_STAT
 	/* Update the last cpu for each level till end_pwrlvl */
@@ -132,7 +141,11 @@ exit:
 	 * Release the locks corresponding to each power level in the
 	 * reverse order to which they were acquired.
 	 */
+#if PSCI_LOCKFREE_COORD
+	psci_coord_release(end_pwrlvl, parent_nodes, locked);
+#else
 	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 
 	/*
 	 * Check if all actions needed to safely power down this cpu have
@@ -150,7 +163,20 @@ exit:
 		psci_flush_cpu_data(psci_svc_cpu_data.aff_info_state);
 		psci_set_aff_info_state(AFF_STATE_OFF);
 		psci_dsbish();
+#if PSCI_TARGETED_CMO
+		/*
+		 * With targeted cache maintenance the data cache may still be
+		 * enabled, in which case the update is only in the cache and
+		 * must be written back rather than discarded.
+		 */
+		if ((read_sctlr_el3() & SCTLR_C_BIT) != 0U) {
+			psci_flush_cpu_data(psci_svc_cpu_data.aff_info_state);
+		} else {
+			psci_inv_cpu_data(psci_svc_cpu_data.aff_info_state);
+		}
+#else
 		psci_inv_cpu_data(psci_svc_cpu_data.aff_info_state);
+#endif
 
 #if ENABLE_RUNTIME_INSTRUMENTATION
 
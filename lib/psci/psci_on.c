@@ -11,8 +11,10 @@
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <common/runtime_svc.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/pubsub_events.h>
+#include <lib/psci/psci_bulk_on.h>
 #include <plat/common/platform.h>
 
 #include "psci_private.h"
@@ -47,37 +49,13 @@ static int cpu_on_validate_state(aff_info_state_t aff_state)
 }
 
 /*******************************************************************************
- * Generic handler which is called to physically power on a cpu identified by
- * its mpidr. It performs the generic, architectural, platform setup and state
- * management to power on the target cpu e.g. it will ensure that
- * enough information is stashed for it to resume execution in the non-secure
- * security state.
- *
- * The state of all the relevant power domains are changed after calling the
- * platform handler as it can return error.
+ * This function checks that the cpu `target_idx`, whose cpu lock is held, is
+ * OFF and moves it to ON_PENDING.
  ******************************************************************************/
-int psci_cpu_on_start(u_register_t target_cpu,
-		      const entry_point_info_t *ep)
+static int cpu_on_prepare(u_register_t target_cpu, unsigned int target_idx)
 {
 	int rc;
 	aff_info_state_t target_aff_state;
-	int ret = plat_core_pos_by_mpidr(target_cpu);
-	unsigned int target_idx = (unsigned int)ret;
-
-	/* Calling function must supply valid input arguments */
-	assert(ret >= 0);
-	assert(ep != NULL);
-
-
-	/*
-	 * This function must only be called on platforms where the
-	 * CPU_ON platform hooks have been implemented.
-	 */
-	assert((psci_plat_pm_ops->pwr_domain_on != NULL) &&
-	       (psci_plat_pm_ops->pwr_domain_on_finish != NULL));
-
-	/* Protect against multiple CPUs trying to turn ON the same target CPU */
-	psci_spin_lock_cpu(target_idx);
 
 	/*
 	 * Generic management: Ensure that the cpu is off to be
@@ -99,7 +77,7 @@ int psci_cpu_on_start(u_register_t target_cpu,
 				psci_svc_cpu_data.aff_info_state);
 	rc = cpu_on_validate_state(psci_get_aff_info_state_by_idx(target_idx));
 	if (rc != PSCI_E_SUCCESS)
-		goto exit;
+		return rc;
 
 	/*
 	 * Call the cpu on handler registered by the Secure Payload Dispatcher
@@ -135,6 +113,19 @@ int psci_cpu_on_start(u_register_t target_cpu,
 		       AFF_STATE_ON_PENDING);
 	}
 
+	return PSCI_E_SUCCESS;
+}
+
+/*******************************************************************************
+ * This function asks the platform to power on the cpu `target_idx`, prepared
+ * by cpu_on_prepare() with its cpu lock held, and stashes the information for
+ * it to enter the non-secure world at `ep`.
+ ******************************************************************************/
+static int cpu_on_issue(u_register_t target_cpu, unsigned int target_idx,
+			const entry_point_info_t *ep)
+{
+	int rc;
+
 	/*
 	 * Perform generic, architecture and platform specific handling.
 	 */
@@ -156,11 +147,148 @@ int psci_cpu_on_start(u_register_t target_cpu,
 					psci_svc_cpu_data.aff_info_state);
 	}
 
-exit:
+	return rc;
+}
+
+/*******************************************************************************
+ * Generic handler which is called to physically power on a cpu identified by
+ * its mpidr. It performs the generic, architectural, platform setup and state
+ * management to power on the target cpu e.g. it will ensure that
+ * enough information is stashed for it to resume execution in the non-secure
+ * security state.
+ *
+ * The state of all the relevant power domains are changed after calling the
+ * platform handler as it can return error.
+ ******************************************************************************/
+int psci_cpu_on_start(u_register_t target_cpu,
+		      const entry_point_info_t *ep)
+{
+	int rc;
+	int ret = plat_core_pos_by_mpidr(target_cpu);
+	unsigned int target_idx = (unsigned int)ret;
+
+	/* Calling function must supply valid input arguments */
+	assert(ret >= 0);
+	assert(ep != NULL);
+
+
+	/*
+	 * This function must only be called on platforms where the
+	 * CPU_ON platform hooks have been implemented.
+	 */
+	assert((psci_plat_pm_ops->pwr_domain_on != NULL) &&
+	       (psci_plat_pm_ops->pwr_domain_on_finish != NULL));
+
+	/* Protect against multiple CPUs trying to turn ON the same target CPU */
+	psci_spin_lock_cpu(target_idx);
+
+	rc = cpu_on_prepare(target_cpu, target_idx);
+	if (rc == PSCI_E_SUCCESS)
+		rc = cpu_on_issue(target_cpu, target_idx, ep);
+
 	psci_spin_unlock_cpu(target_idx);
 	return rc;
 }
 
+#if PSCI_BULK_ON
+/*******************************************************************************
+ * This function powers on the cpus selected by `cpu_map`, bit n standing for
+ * the cpu with MPIDR `base_mpidr` and Aff0 n, which must all exist, for them
+ * to enter the non-secure world at `ep`. It returns the bitmap of the cpus
+ * which are powering on.
+ *
+ * All the selected cpus are first checked and moved to ON_PENDING, then the
+ * platform is asked to power them on back-to-back. The cpu lock of each cpu is
+ * held from the first step until its context is initialised. The locks are
+ * taken in the order of the bits: two callers selecting the same cpu share
+ * `base_mpidr`, so they cannot deadlock.
+ ******************************************************************************/
+static u_register_t psci_cpu_on_bulk(u_register_t base_mpidr,
+				     u_register_t cpu_map,
+				     const entry_point_info_t *ep)
+{
+	u_register_t map = 0U, target_cpu;
+	unsigned int n, target_idx;
+
+	for (n = 0U; n < (sizeof(cpu_map) * 8U); n++) {
+		if ((cpu_map & BIT(n)) == 0U)
+			continue;
+
+		target_cpu = base_mpidr | n;
+		target_idx = (unsigned int)plat_core_pos_by_mpidr(target_cpu);
+		psci_spin_lock_cpu(target_idx);
+		if (cpu_on_prepare(target_cpu, target_idx) == PSCI_E_SUCCESS) {
+			map |= BIT(n);
+			continue;
+		}
+
+		psci_spin_unlock_cpu(target_idx);
+	}
+
+	for (n = 0U; n < (sizeof(map) * 8U); n++) {
+		if ((map & BIT(n)) == 0U)
+			continue;
+
+		target_cpu = base_mpidr | n;
+		target_idx = (unsigned int)plat_core_pos_by_mpidr(target_cpu);
+		if (cpu_on_issue(target_cpu, target_idx, ep) != PSCI_E_SUCCESS)
+			map &= ~BIT(n);
+
+		psci_spin_unlock_cpu(target_idx);
+	}
+
+	return map;
+}
+
+/*******************************************************************************
+ * Handle the SiP call powering on several cpus, see psci_bulk_on.h.
+ ******************************************************************************/
+uintptr_t psci_bulk_on_smc_handler(unsigned int smc_fid,
+				   u_register_t entrypoint,
+				   u_register_t context_id,
+				   u_register_t base_mpidr,
+				   u_register_t cpu_map,
+				   void *cookie,
+				   void *handle,
+				   u_register_t flags)
+{
+	entry_point_info_t ep;
+	unsigned int n;
+	int rc;
+
+	if (!is_caller_non_secure(flags))
+		SMC_RET1(handle, PSCI_E_DENIED);
+
+	if (psci_features(PSCI_CPU_ON_AARCH64) != PSCI_E_SUCCESS)
+		SMC_RET1(handle, PSCI_E_NOT_SUPPORTED);
+
+	if (GET_SMC_CC(smc_fid) == SMC_32) {
+		entrypoint = (uint32_t)entrypoint;
+		context_id = (uint32_t)context_id;
+		base_mpidr = (uint32_t)base_mpidr;
+		cpu_map = (uint32_t)cpu_map;
+	}
+
+	if ((base_mpidr & MPIDR_CPU_MASK) != 0U)
+		SMC_RET1(handle, PSCI_E_INVALID_PARAMS);
+
+	/* Determine if the cpus exist */
+	for (n = 0U; n < (sizeof(cpu_map) * 8U); n++) {
+		if (((cpu_map & BIT(n)) != 0U) &&
+		    (psci_validate_mpidr(base_mpidr | n) != PSCI_E_SUCCESS))
+			SMC_RET1(handle, PSCI_E_INVALID_PARAMS);
+	}
+
+	/* Validate the entry point and get the entry_point_info */
+	rc = psci_validate_entry_point(&ep, entrypoint, context_id);
+	if (rc != PSCI_E_SUCCESS)
+		SMC_RET1(handle, rc);
+
+	SMC_RET2(handle, PSCI_E_SUCCESS,
+		 psci_cpu_on_bulk(base_mpidr, cpu_map, &ep));
+}
+#endif /* PSCI_BULK_ON */
+
 /*******************************************************************************
  * The following function finish an earlier power on request. They
  * are called by the common finisher routine in psci_common.c. The `state_info`
@@ -285,6 +285,17 @@ void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   const unsigned int *parent_nodes);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
 				   const unsigned int *parent_nodes);
+#if PSCI_LOCKFREE_COORD
+void psci_coord_init(void);
+unsigned int psci_coord_pwr_down(unsigned int end_pwrlvl,
+				 const unsigned int *parent_nodes,
+				 psci_power_state_t *state_info);
+unsigned int psci_coord_pwr_up(unsigned int end_pwrlvl,
+			       const unsigned int *parent_nodes);
+void psci_coord_release(unsigned int end_pwrlvl,
+			const unsigned int *parent_nodes,
+			unsigned int locked);
+#endif
 int psci_validate_suspend_req(const psci_power_state_t *state_info,
 			      unsigned int is_power_down_state);
 unsigned int psci_find_max_off_lvl(const psci_power_state_t *state_info);
@@ -301,6 +312,10 @@ void psci_do_pwrdown_sequence(unsigned int power_level);
  * handled in assembly.
  */
 void prepare_cpu_pwr_dwn(unsigned int power_level);
+#if PSCI_TARGETED_CMO
+bool cpu_has_pwr_dwn_noflush(void);
+void prepare_cpu_pwr_dwn_noflush(unsigned int power_level);
+#endif
 
 /* Private exported functions from psci_on.c */
 int psci_cpu_on_start(u_register_t target_cpu,
@@ -322,6 +337,10 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx, const psci_power_state_t *sta
 /* Private exported functions from psci_helpers.S */
 void psci_do_pwrdown_cache_maintenance(unsigned int pwr_level);
 void psci_do_pwrup_cache_maintenance(void);
+#if PSCI_LOCKFREE_COORD
+unsigned int psci_coord_cas(unsigned int *word, unsigned int old,
+			    unsigned int new);
+#endif
 
 /* Private exported functions from psci_system_off.c */
 void __dead2 psci_system_off(void);
@@ -338,6 +357,11 @@ u_register_t psci_stat_residency(u_register_t target_cpu,
 u_register_t psci_stat_count(u_register_t target_cpu,
 			unsigned int power_state);
 
+/* Private exported functions from psci_idle_policy.c */
+void psci_idle_policy_record(unsigned int cpu_idx, u_register_t residency);
+bool psci_idle_policy_apply(psci_power_state_t *state_info,
+			    unsigned int is_power_down_state);
+
 /* Private exported functions from psci_mem_protect.c */
 u_register_t psci_mem_protect(unsigned int enable);
 u_register_t psci_mem_chk_range(uintptr_t base, u_register_t length);
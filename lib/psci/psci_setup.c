@@ -13,6 +13,7 @@
 #include <context.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/cpus/errata_report.h>
+#include <lib/psci/psci_cmo.h>
 #include <plat/common/platform.h>
 
 #include "psci_private.h"
@@ -30,6 +31,7 @@ CASSERT(PLATFORM_CORE_COUNT <= (PSCI_MAX_CPUS_INDEX + 1U), assert_psci_cores_ove
  * of relying on platform defined constants.
  ******************************************************************************/
 static cpu_context_t psci_ns_context[PLATFORM_CORE_COUNT];
+REGISTER_PSCI_CMO_PERCPU_ARRAY(psci_ns_context);
 
 /******************************************************************************
  * Define the psci capability variable.
@@ -229,6 +231,10 @@ int __init psci_setup(const psci_lib_args_t *lib_args)
 	 */
 	psci_set_pwr_domains_to_run(PLAT_MAX_PWR_LVL);
 
+#if PSCI_LOCKFREE_COORD
+	psci_coord_init();
+#endif
+
 	(void) plat_setup_psci_ops((uintptr_t)lib_args->mailbox_ep,
 				   &psci_plat_pm_ops);
 	assert(psci_plat_pm_ops != NULL);
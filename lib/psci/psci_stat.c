@@ -8,7 +8,12 @@
 
 #include <platform_def.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
+#include <common/runtime_svc.h>
+#include <lib/pmf/pmf.h>
+#include <lib/psci/psci_stat_hist.h>
+#include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
 
 #include "psci_private.h"
@@ -21,6 +26,16 @@
 typedef struct psci_stat {
 	u_register_t residency;
 	u_register_t count;
+#if PSCI_STAT_HIST
+	/* Stays shorter than the target residency of the state */
+	u_register_t premature;
+	/* Time spent in EL3 entering and leaving the state, in ticks */
+	uint64_t entry_ticks;
+	uint64_t exit_ticks;
+	uint64_t max_entry_ticks;
+	uint64_t max_exit_ticks;
+	uint32_t hist[PSCI_STAT_HIST_BUCKETS];
+#endif
 } psci_stat_t;
 
 /*
@@ -62,6 +77,78 @@ static int get_stat_idx(plat_local_state_t local_state, unsigned int pwr_lvl)
 	return idx;
 }
 
+#if PSCI_STAT_HIST
+/*******************************************************************************
+ * This function returns the latencies of the last low power state entry from
+ * the runtime instrumentation timestamps. The entry latency runs from the PSCI
+ * call of `last_cpu_idx`, the last CPU of the power domain to suspend, to its
+ * entry into the state. The exit latency runs from the wakeup of the current
+ * CPU to now, i.e. the part of the PSCI finishers done so far.
+ ******************************************************************************/
+static void psci_stat_get_latency(const psci_power_state_t *state_info,
+				  unsigned int last_cpu_idx,
+				  uint64_t *entry, uint64_t *exit)
+{
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	unsigned long long enter_psci_ts, enter_low_pwr_ts, exit_low_pwr_ts;
+	unsigned int pmf_flags;
+
+	/* Timestamps captured with caches off need cache maintenance */
+	if (is_local_state_off(
+		state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]) != 0)
+		pmf_flags = PMF_CACHE_MAINT;
+	else
+		pmf_flags = PMF_NO_CACHE_MAINT;
+
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_ENTER_PSCI,
+		last_cpu_idx, pmf_flags, enter_psci_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_ENTER_HW_LOW_PWR,
+		last_cpu_idx, pmf_flags, enter_low_pwr_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_EXIT_HW_LOW_PWR,
+		plat_my_core_pos(), pmf_flags, exit_low_pwr_ts);
+
+	*entry = (enter_low_pwr_ts > enter_psci_ts) ?
+		(enter_low_pwr_ts - enter_psci_ts) : 0U;
+	*exit = read_cntpct_el0() - exit_low_pwr_ts;
+#else
+	*entry = 0U;
+	*exit = 0U;
+#endif
+}
+
+/*******************************************************************************
+ * This function updates the residency histogram, the premature wakeup count
+ * and the latencies of `psci_stat` for a stay of `residency` microseconds of a
+ * power domain at level `lvl` in `local_state`.
+ ******************************************************************************/
+static void psci_stat_hist_update(psci_stat_t *psci_stat, unsigned int lvl,
+				  plat_local_state_t local_state,
+				  const psci_power_state_t *state_info,
+				  unsigned int last_cpu_idx,
+				  u_register_t residency)
+{
+	unsigned int bucket;
+	uint64_t entry, exit;
+
+	bucket = (residency == 0U) ? 0U :
+		(63U - (unsigned int)__builtin_clzll(residency));
+	if (bucket >= PSCI_STAT_HIST_BUCKETS)
+		bucket = PSCI_STAT_HIST_BUCKETS - 1U;
+	psci_stat->hist[bucket]++;
+
+	if (residency < plat_psci_stat_get_target_residency(lvl, local_state))
+		psci_stat->premature++;
+
+	psci_stat_get_latency(state_info, last_cpu_idx, &entry, &exit);
+	psci_stat->entry_ticks += entry;
+	psci_stat->exit_ticks += exit;
+	if (entry > psci_stat->max_entry_ticks)
+		psci_stat->max_entry_ticks = entry;
+	if (exit > psci_stat->max_exit_ticks)
+		psci_stat->max_exit_ticks = exit;
+}
+#endif /* PSCI_STAT_HIST */
+
 /*******************************************************************************
  * This function is passed the target local power states for each power
  * domain (state_info) between the current CPU domain and its ancestors until
@@ -109,7 +196,7 @@ void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
 void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 			const psci_power_state_t *state_info)
 {
-	unsigned int lvl, parent_idx;
+	unsigned int lvl, parent_idx, last_cpu_idx;
 	unsigned int cpu_idx = plat_my_core_pos();
 	int stat_idx;
 	plat_local_state_t local_state;
@@ -129,6 +216,13 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	/* Update CPU stats. */
 	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
 	psci_cpu_stat[cpu_idx][stat_idx].count++;
+#if PSCI_STAT_HIST
+	psci_stat_hist_update(&psci_cpu_stat[cpu_idx][stat_idx],
+		PSCI_CPU_PWR_LVL, local_state, state_info, cpu_idx, residency);
+#endif
+#if PSCI_IDLE_POLICY
+	psci_idle_policy_record(cpu_idx, residency);
+#endif
 
 	/*
 	 * Check what power domains above CPU were off
@@ -147,10 +241,11 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 		}
 
 		assert(last_cpu_in_non_cpu_pd[parent_idx] != -1);
+		last_cpu_idx = (unsigned int)last_cpu_in_non_cpu_pd[parent_idx];
 
 		/* Call into platform interface to calculate residency. */
 		residency = plat_psci_stat_get_residency(lvl, state_info,
-			(unsigned int)last_cpu_in_non_cpu_pd[parent_idx]);
+			last_cpu_idx);
 
 		/* Initialize back to reset value */
 		last_cpu_in_non_cpu_pd[parent_idx] = -1;
@@ -161,6 +256,10 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 		/* Update non cpu stats */
 		psci_non_cpu_stat[parent_idx][stat_idx].residency += residency;
 		psci_non_cpu_stat[parent_idx][stat_idx].count++;
+#if PSCI_STAT_HIST
+		psci_stat_hist_update(&psci_non_cpu_stat[parent_idx][stat_idx],
+			lvl, local_state, state_info, last_cpu_idx, residency);
+#endif
 
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
@@ -248,3 +347,59 @@ u_register_t psci_stat_count(u_register_t target_cpu,
 	else
 		return 0;
 }
+
+#if PSCI_STAT_HIST
+/*******************************************************************************
+ * Handle the SiP call reading the extended PSCI statistics, see
+ * psci_stat_hist.h. The statistics of a power domain may be updated while they
+ * are read, in which case they are returned torn.
+ ******************************************************************************/
+uintptr_t psci_stat_hist_smc_handler(unsigned int smc_fid,
+				     u_register_t cmd,
+				     u_register_t x2,
+				     u_register_t x3,
+				     u_register_t x4,
+				     void *cookie,
+				     void *handle,
+				     u_register_t flags)
+{
+	psci_stat_t psci_stat;
+	uint32_t bkt[PSCI_STAT_HIST_BUCKETS_PER_CALL] = { 0 };
+	unsigned int i;
+
+	switch (cmd) {
+	case PSCI_STAT_HIST_INFO:
+		SMC_RET3(handle, SMC_OK, PSCI_STAT_HIST_BUCKETS,
+			 read_cntfrq_el0());
+
+	case PSCI_STAT_HIST_STATE:
+		if (psci_get_stat(x2, (unsigned int)x3, &psci_stat) !=
+		    PSCI_E_SUCCESS)
+			break;
+
+		SMC_RET8(handle, SMC_OK, psci_stat.count, psci_stat.residency,
+			 psci_stat.premature, psci_stat.entry_ticks,
+			 psci_stat.exit_ticks, psci_stat.max_entry_ticks,
+			 psci_stat.max_exit_ticks);
+
+	case PSCI_STAT_HIST_BKTS:
+		if ((x4 >= PSCI_STAT_HIST_BUCKETS) ||
+		    (psci_get_stat(x2, (unsigned int)x3, &psci_stat) !=
+		     PSCI_E_SUCCESS))
+			break;
+
+		for (i = 0U; i < PSCI_STAT_HIST_BUCKETS_PER_CALL; i++) {
+			if ((x4 + i) < PSCI_STAT_HIST_BUCKETS)
+				bkt[i] = psci_stat.hist[x4 + i];
+		}
+
+		SMC_RET7(handle, SMC_OK, bkt[0], bkt[1], bkt[2], bkt[3],
+			 bkt[4], bkt[5]);
+
+	default:
+		break;
+	}
+
+	SMC_RET1(handle, SMC_UNK);
+}
+#endif /* PSCI_STAT_HIST */
@@ -30,11 +30,18 @@ static void psci_suspend_to_standby_finisher(unsigned int cpu_idx,
 {
 	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
 	psci_power_state_t state_info;
+#if PSCI_LOCKFREE_COORD
+	unsigned int locked;
+#endif
 
 	/* Get the parent nodes */
 	psci_get_parent_pwr_domain_nodes(cpu_idx, end_pwrlvl, parent_nodes);
 
+#if PSCI_LOCKFREE_COORD
+	locked = psci_coord_pwr_up(end_pwrlvl, parent_nodes);
+#else
 	psci_acquire_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 
 	/*
 	 * Find out which retention states this CPU has exited from until the
@@ -60,7 +67,11 @@ static void psci_suspend_to_standby_finisher(unsigned int cpu_idx,
 	 */
 	psci_set_pwr_domains_to_run(end_pwrlvl);
 
+#if PSCI_LOCKFREE_COORD
+	psci_coord_release(end_pwrlvl, parent_nodes, locked);
+#else
 	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 }
 
 /*******************************************************************************
@@ -121,8 +132,6 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
 
 	/*
 	 * Arch. management. Initiate power down sequence.
-	 * TODO : Introduce a mechanism to query the cache level to flush
-	 * and the cpu-ops power down to perform from the platform.
 	 */
 	psci_do_pwrdown_sequence(max_off_lvl);
 
@@ -159,6 +168,9 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	int skip_wfi = 0;
 	unsigned int idx = plat_my_core_pos();
 	unsigned int parent_nodes[PLAT_MAX_PWR_LVL] = {0};
+#if PSCI_LOCKFREE_COORD
+	unsigned int locked = 0U;
+#endif
 
 	/*
 	 * This function must only be called on platforms where the
@@ -175,7 +187,9 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	 * level so that by the time all locks are taken, the system topology
 	 * is snapshot and state management can be done safely.
 	 */
+#if !PSCI_LOCKFREE_COORD
 	psci_acquire_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 
 	/*
 	 * We check if there are any pending interrupts after the delay
@@ -192,7 +206,11 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	 * it returns the negotiated state info for each power level upto
 	 * the end level specified.
 	 */
+#if PSCI_LOCKFREE_COORD
+	locked = psci_coord_pwr_down(end_pwrlvl, parent_nodes, state_info);
+#else
 	psci_do_state_coordination(end_pwrlvl, state_info);
+#endif
 
 #if ENABLE_PSCI_STAT
 	/* Update the last cpu for each level till end_pwrlvl */
@@ -219,7 +237,11 @@ exit:
 	 * Release the locks corresponding to each power level in the
 	 * reverse order to which they were acquired.
 	 */
+#if PSCI_LOCKFREE_COORD
+	psci_coord_release(end_pwrlvl, parent_nodes, locked);
+#else
 	psci_release_pwr_domain_locks(end_pwrlvl, parent_nodes);
+#endif
 
 	if (skip_wfi == 1)
 		return;
@@ -60,6 +60,10 @@ CTX_INCLUDE_AARCH32_REGS	:= 1
 # Include FP registers in cpu context
 CTX_INCLUDE_FPREGS		:= 0
 
+# Switch the FP/SIMD registers between the worlds lazily, on the first access
+# after a world switch. Requires CTX_INCLUDE_FPREGS
+CTX_FPREGS_LAZY			:= 0
+
 # Include pointer authentication (ARMv8.3-PAuth) registers in cpu context. This
 # must be set to 1 if the platform wants to use this feature in the Secure
 # world. It is not needed to use it in the Non-secure world.
@@ -178,6 +182,9 @@ ifeq ($(KEY_ALG),rsa)
 KEY_SIZE			:= 2048
 endif
 
+# Record the contention, wait and hold times of the registered locks of BL31
+LOCK_PROFILING			:= 0
+
 # Option to build TF with Measured Boot support
 MEASURED_BOOT			:= 0
 
@@ -194,9 +201,28 @@ PL011_GENERIC_UART		:= 0
 # The platform Makefile is free to override this value.
 PROGRAMMABLE_RESET_ADDRESS	:= 0
 
+# Let the normal world power on several CPUs with one SiP call
+PSCI_BULK_ON			:= 0
+
 # Flag used to choose the power state format: Extended State-ID or Original
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Let BL31 demote or promote the power domain levels of CPU_SUSPEND requests
+# from the past idle periods of the calling CPU
+PSCI_IDLE_POLICY		:= 0
+
+# Flag to let CPUs which are not the last to power down, or the first to power
+# up, in their cluster skip the PSCI power domain locks
+PSCI_LOCKFREE_COORD		:= 0
+
+# Keep residency histograms, premature wakeup counts and entry and exit
+# latencies of the PSCI power states on top of the PSCI_STAT ones
+PSCI_STAT_HIST			:= 0
+
+# Let the platform replace the set/way cache maintenance of a CPU power down
+# with the cleaning of the registered EL3 data by VA
+PSCI_TARGETED_CMO		:= 0
+
 # Enable RAS support
 RAS_EXTENSION			:= 0
 
@@ -224,6 +250,19 @@ SEPARATE_NOBITS_REGION		:= 0
 # cores stack
 RECLAIM_INIT_CODE		:= 0
 
+# Keep per-cpu counts and latency histograms of the SMCs handled by BL31
+SMC_ACCOUNTING			:= 0
+
+# Number of distinct SMC function IDs SMC_ACCOUNTING tracks per cpu
+SMC_ACCOUNTING_FIDS		:= 16
+
+# Provide a SiP call issuing a buffer of SMCs in a single entry into BL31
+SMC_BATCH			:= 0
+
+# Only save and restore x0-x18 around the fast SMCs whose handlers neither
+# switch worlds nor read the caller's x19-x29
+SMC_LIGHT_ENTRY			:= 0
+
 # SPD choice
 SPD				:= none
 
@@ -280,6 +319,10 @@ V				:= 0
 # platforms).
 WARMBOOT_ENABLE_DCACHE_EARLY	:= 0
 
+# Whether to keep per-cpu images of the context state computed on CPU_ON and
+# warm boot, rather than recomputing it every time.
+WARMBOOT_GOLDEN_CTX		:= 0
+
 # Build option to enable/disable the Statistical Profiling Extensions
 ENABLE_SPE_FOR_LOWER_ELS	:= 0
 
@@ -312,6 +355,11 @@ SANITIZE_UB := off
 # Default: disabled
 USE_SPINLOCK_CAS := 0
 
+# For ARMv8.1 (AArch64) platforms with hardware-assisted coherency, enabling
+# this option selects ticket spinlocks and MCS queued bakery locks.
+# Default: disabled
+QUEUED_LOCKS := 0
+
 # Enable Link Time Optimization
 ENABLE_LTO			:= 0
 
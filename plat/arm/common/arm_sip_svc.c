@@ -8,13 +8,21 @@
 
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <common/runtime_svc_acct.h>
+#include <common/runtime_svc_batch.h>
 #include <drivers/arm/ethosn.h>
 #include <lib/debugfs.h>
+#include <lib/lock_prof.h>
 #include <lib/pmf/pmf.h>
+#include <lib/psci/psci_bulk_on.h>
+#include <lib/psci/psci_idle_policy.h>
+#include <lib/psci/psci_stat_hist.h>
 #include <plat/arm/common/arm_sip_svc.h>
 #include <plat/arm/common/plat_arm.h>
 #include <tools_share/uuid.h>
 
+#include <platform_def.h>
+
 /* ARM SiP Service UUID */
 DEFINE_SVC_UUID2(arm_sip_svc_uid,
 	0x556d75e2, 0x6033, 0xb54b, 0xb5, 0x75,
@@ -73,6 +81,60 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 
 #endif /* USE_DEBUGFS */
 
+#if SMC_ACCOUNTING
+
+	if (is_smc_acct_fid(smc_fid)) {
+		return smc_acct_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					    handle, flags);
+	}
+
+#endif /* SMC_ACCOUNTING */
+
+#if SMC_BATCH
+
+	if (is_smc_batch_fid(smc_fid)) {
+		return smc_batch_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					     handle, flags);
+	}
+
+#endif /* SMC_BATCH */
+
+#if LOCK_PROFILING
+
+	if (is_lock_prof_fid(smc_fid)) {
+		return lock_prof_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					     handle, flags);
+	}
+
+#endif /* LOCK_PROFILING */
+
+#if PSCI_STAT_HIST
+
+	if (is_psci_stat_hist_fid(smc_fid)) {
+		return psci_stat_hist_smc_handler(smc_fid, x1, x2, x3, x4,
+						  cookie, handle, flags);
+	}
+
+#endif /* PSCI_STAT_HIST */
+
+#if PSCI_IDLE_POLICY
+
+	if (is_psci_idle_policy_fid(smc_fid)) {
+		return psci_idle_policy_smc_handler(smc_fid, x1, x2, x3, x4,
+						    cookie, handle, flags);
+	}
+
+#endif /* PSCI_IDLE_POLICY */
+
+#if PSCI_BULK_ON
+
+	if (is_psci_bulk_on_fid(smc_fid)) {
+		return psci_bulk_on_smc_handler(smc_fid, x1, x2, x3, x4,
+						cookie, handle, flags);
+	}
+
+#endif /* PSCI_BULK_ON */
+
 #if ARM_ETHOSN_NPU_DRIVER
 
 	if (is_ethosn_fid(smc_fid)) {
@@ -132,6 +194,91 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 }
 
 
+#if SMC_LIGHT_ENTRY
+/*
+ * None of the PMF, SMC accounting, lock profiling, PSCI statistics and SiP
+ * query handlers switch worlds or look at the caller's x19-x29.
+ */
+bool plat_is_light_smc(uint32_t smc_fid)
+{
+	switch (smc_fid) {
+	case PMF_SMC_GET_TIMESTAMP_32:
+	case PMF_SMC_GET_TIMESTAMP_64:
+#if SMC_ACCOUNTING
+	case SMC_ACCT_SMC_32:
+	case SMC_ACCT_SMC_64:
+#endif
+#if LOCK_PROFILING
+	case LOCK_PROF_SMC_32:
+	case LOCK_PROF_SMC_64:
+#endif
+#if PSCI_STAT_HIST
+	case PSCI_STAT_HIST_SMC_32:
+	case PSCI_STAT_HIST_SMC_64:
+#endif
+	case ARM_SIP_SVC_CALL_COUNT:
+	case ARM_SIP_SVC_UID:
+	case ARM_SIP_SVC_VERSION:
+		return true;
+	default:
+		return false;
+	}
+}
+#endif /* SMC_LIGHT_ENTRY */
+
+#if SMC_BATCH
+/*
+ * The PMF timestamp, SMC accounting and SiP query handlers only use the
+ * general purpose registers of the caller's context.
+ */
+bool plat_is_batchable_smc(uint32_t smc_fid)
+{
+	switch (smc_fid) {
+	case PMF_SMC_GET_TIMESTAMP_32:
+	case PMF_SMC_GET_TIMESTAMP_64:
+#if SMC_ACCOUNTING
+	case SMC_ACCT_SMC_32:
+	case SMC_ACCT_SMC_64:
+#endif
+#if LOCK_PROFILING
+	case LOCK_PROF_SMC_32:
+	case LOCK_PROF_SMC_64:
+#endif
+#if PSCI_STAT_HIST
+	case PSCI_STAT_HIST_SMC_32:
+	case PSCI_STAT_HIST_SMC_64:
+#endif
+	case ARM_SIP_SVC_CALL_COUNT:
+	case ARM_SIP_SVC_UID:
+	case ARM_SIP_SVC_VERSION:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Only accept SMC batch buffers which lie entirely in one of the Non-secure
+ * DRAM ranges.
+ */
+int plat_smc_batch_validate_buf(uintptr_t pa, size_t size)
+{
+	if ((pa >= ARM_NS_DRAM1_BASE) &&
+	    (size <= ARM_NS_DRAM1_SIZE) &&
+	    ((pa - ARM_NS_DRAM1_BASE) <= (ARM_NS_DRAM1_SIZE - size))) {
+		return 0;
+	}
+
+	if ((pa >= ARM_DRAM2_BASE) &&
+	    (size <= ARM_DRAM2_SIZE) &&
+	    ((pa - ARM_DRAM2_BASE) <= (ARM_DRAM2_SIZE - size))) {
+		return 0;
+	}
+
+	return -1;
+}
+#endif /* SMC_BATCH */
+
 /* Define a runtime service descriptor for fast SMC calls */
 DECLARE_RT_SVC(
 	arm_sip_svc,
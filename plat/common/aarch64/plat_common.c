@@ -30,6 +30,15 @@
 
 #pragma weak plat_ea_handler
 
+#if SMC_LIGHT_ENTRY
+#pragma weak plat_is_light_smc
+#endif
+
+#if SMC_BATCH
+#pragma weak plat_is_batchable_smc
+#pragma weak plat_smc_batch_validate_buf
+#endif
+
 void bl31_plat_runtime_setup(void)
 {
 	console_switch_state(CONSOLE_FLAG_RUNTIME);
@@ -66,6 +75,37 @@ int plat_sdei_validate_entry_point(uintptr_t ep, unsigned int client_mode)
 }
 #endif
 
+#if SMC_LIGHT_ENTRY
+/*
+ * Default function telling that none of the platform SMCs may skip saving the
+ * caller's x19-x29, see rt_svc_is_light_smc().
+ */
+bool plat_is_light_smc(uint32_t smc_fid)
+{
+	return false;
+}
+#endif
+
+#if SMC_BATCH
+/*
+ * Default function telling that none of the platform SMCs may be issued
+ * through an SMC batch.
+ */
+bool plat_is_batchable_smc(uint32_t smc_fid)
+{
+	return false;
+}
+
+/*
+ * Default function rejecting every SMC batch buffer, as the Non-secure DRAM
+ * ranges are not known here.
+ */
+int plat_smc_batch_validate_buf(uintptr_t pa, size_t size)
+{
+	return -1;
+}
+#endif
+
 #if !ENABLE_BACKTRACE
 static const char *get_el_str(unsigned int el)
 {
@@ -133,6 +133,34 @@ u_register_t plat_psci_stat_get_residency(unsigned int lvl,
 }
 #endif /* ENABLE_PSCI_STAT && ENABLE_PMF */
 
+#if PSCI_STAT_HIST
+#pragma weak plat_psci_stat_get_target_residency
+
+/*
+ * By default no local power state has a target residency, so that no wakeup
+ * is counted as premature.
+ */
+u_register_t plat_psci_stat_get_target_residency(
+	__unused unsigned int lvl,
+	__unused plat_local_state_t local_state)
+{
+	return 0U;
+}
+#endif /* PSCI_STAT_HIST */
+
+#if PSCI_TARGETED_CMO
+#pragma weak plat_psci_pwrdown_hw_cache_clean
+
+/*
+ * By default the caches of a CPU are written back in software at every power
+ * down.
+ */
+bool plat_psci_pwrdown_hw_cache_clean(__unused unsigned int pwr_lvl)
+{
+	return false;
+}
+#endif /* PSCI_TARGETED_CMO */
+
 /*
  * The PSCI generic code uses this API to let the platform participate in state
  * coordination during a power management operation. It compares the platform
@@ -94,10 +94,49 @@ static int32_t smccc_arch_id(u_register_t arg1)
 	return SMC_ARCH_CALL_INVAL_PARAM;
 }
 
+static uintptr_t smccc_version_handler(uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t x4,
+	void *cookie,
+	void *handle,
+	u_register_t flags)
+{
+	SMC_RET1(handle, smccc_version());
+}
+
+static uintptr_t smccc_arch_features_handler(uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t x4,
+	void *cookie,
+	void *handle,
+	u_register_t flags)
+{
+	SMC_RET1(handle, smccc_arch_features(x1));
+}
+
+static uintptr_t smccc_arch_soc_id_handler(uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t x4,
+	void *cookie,
+	void *handle,
+	u_register_t flags)
+{
+	SMC_RET1(handle, smccc_arch_id(x1));
+}
+
+#if WORKAROUND_CVE_2017_5715 || WORKAROUND_CVE_2018_3639
 /*
- * Top-level Arm Architectural Service SMC handler.
+ * The workarounds have already been applied on affected PEs during entry to
+ * EL3, dynamically where that is required. On unaffected or statically
+ * mitigated PEs, these functions have no effect.
  */
-static uintptr_t arm_arch_svc_smc_handler(uint32_t smc_fid,
+static uintptr_t smccc_arch_workaround_handler(uint32_t smc_fid,
 	u_register_t x1,
 	u_register_t x2,
 	u_register_t x3,
@@ -106,37 +145,52 @@ static uintptr_t arm_arch_svc_smc_handler(uint32_t smc_fid,
 	void *handle,
 	u_register_t flags)
 {
-	switch (smc_fid) {
-	case SMCCC_VERSION:
-		SMC_RET1(handle, smccc_version());
-	case SMCCC_ARCH_FEATURES:
-		SMC_RET1(handle, smccc_arch_features(x1));
-	case SMCCC_ARCH_SOC_ID:
-		SMC_RET1(handle, smccc_arch_id(x1));
+	SMC_RET0(handle);
+}
+#endif
+
+static const rt_svc_fid_range_t arm_arch_svc_fids[] = {
+	RT_SVC_FID(SMCCC_VERSION, smccc_version_handler),
+	RT_SVC_FID(SMCCC_ARCH_FEATURES, smccc_arch_features_handler),
+	RT_SVC_FID(SMCCC_ARCH_SOC_ID, smccc_arch_soc_id_handler),
 #if WORKAROUND_CVE_2017_5715
-	case SMCCC_ARCH_WORKAROUND_1:
-		/*
-		 * The workaround has already been applied on affected PEs
-		 * during entry to EL3.  On unaffected PEs, this function
-		 * has no effect.
-		 */
-		SMC_RET0(handle);
+	RT_SVC_FID(SMCCC_ARCH_WORKAROUND_1, smccc_arch_workaround_handler),
 #endif
 #if WORKAROUND_CVE_2018_3639
-	case SMCCC_ARCH_WORKAROUND_2:
-		/*
-		 * The workaround has already been applied on affected PEs
-		 * requiring dynamic mitigation during entry to EL3.
-		 * On unaffected or statically mitigated PEs, this function
-		 * has no effect.
-		 */
-		SMC_RET0(handle);
+	RT_SVC_FID(SMCCC_ARCH_WORKAROUND_2, smccc_arch_workaround_handler),
 #endif
-	default:
+};
+
+/* SMC32 function numbers 0x0000-0x00ff, 0x7f00-0x7fff and 0x8000-0x80ff */
+DEFINE_RT_SVC_FID_TABLE(arm_arch_svc_fid_table, arm_arch_svc_fids, 3U);
+
+static int32_t arm_arch_svc_setup(void)
+{
+	return rt_svc_fid_table_init(&arm_arch_svc_fid_table);
+}
+
+/*
+ * Top-level Arm Architectural Service SMC handler.
+ */
+static uintptr_t arm_arch_svc_smc_handler(uint32_t smc_fid,
+	u_register_t x1,
+	u_register_t x2,
+	u_register_t x3,
+	u_register_t x4,
+	void *cookie,
+	void *handle,
+	u_register_t flags)
+{
+	rt_svc_handle_t handler = rt_svc_fid_lookup(&arm_arch_svc_fid_table,
+						    smc_fid);
+
+	if (handler == NULL) {
 		WARN("Unimplemented Arm Architecture Service Call: 0x%x \n",
 			smc_fid);
 		SMC_RET1(handle, SMC_UNK);
 	}
+
+	return handler(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
 }
 
 /* Register Standard Service Calls as runtime service */
@@ -145,6 +199,6 @@ DECLARE_RT_SVC(
 		OEN_ARM_START,
 		OEN_ARM_END,
 		SMC_TYPE_FAST,
-		NULL,
+		arm_arch_svc_setup,
 		arm_arch_svc_smc_handler
 );
@@ -129,7 +129,7 @@ typedef struct optee_context {
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
-} optee_context_t;
+} __aligned(CACHE_WRITEBACK_GRANULE) optee_context_t;
 
 /* OPTEED power management handlers */
 extern const spd_pm_ops_t opteed_pm;
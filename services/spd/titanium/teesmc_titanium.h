@@ -27,11 +27,15 @@
  * Register usage:
  * r0/x0	SMC Function ID, TEESMC_TITANIUM_RETURN_ENTRY_DONE
  * r1/x1	Pointer to entry vector
+ * r2/x2	TEESMC_TITANIUM_ENTRY_FLAG_* (only with TITANIUM_LAZY_TIMER)
  */
 #define TEESMC_TITANIUM_FUNCID_RETURN_ENTRY_DONE		0
 #define TEESMC_TITANIUM_RETURN_ENTRY_DONE \
 	TEESMC_TITANIUM_RV(TEESMC_TITANIUM_FUNCID_RETURN_ENTRY_DONE)
 
+/* TITANIUM programs the EL2 physical or virtual timer */
+#define TEESMC_TITANIUM_ENTRY_FLAG_USES_TIMER		(1 << 0)
+
 
 
 /*
@@ -120,4 +124,37 @@
 #define TEESMC_TITANIUM_RETURN_SYSTEM_RESET_DONE \
 	TEESMC_TITANIUM_RV(TEESMC_TITANIUM_FUNCID_RETURN_SYSTEM_RESET_DONE)
 
+/*
+ * Issued from the "fiq" vector when it was entered with TITANIUM_FIQ_LIGHT
+ * (x1 on entry) and the handler needs EL2 registers other than the host
+ * ones. The dispatcher completes the world switch and returns to TITANIUM.
+ *
+ * Register usage:
+ * r0/x0	SMC Function ID, TEESMC_TITANIUM_FIQ_FULL_SWITCH
+ */
+#define TEESMC_TITANIUM_FUNCID_FIQ_FULL_SWITCH		9
+#define TEESMC_TITANIUM_FIQ_FULL_SWITCH \
+	TEESMC_TITANIUM_RV(TEESMC_TITANIUM_FUNCID_FIQ_FULL_SWITCH)
+
+/*
+ * Issued by the normal world to read the world switch statistics of a cpu.
+ * Handled by the dispatcher itself when built with TITANIUM_INSTRUMENTATION,
+ * it never reaches TITANIUM.
+ *
+ * Call register usage:
+ * x0	SMC Function ID, TEESMC_TITANIUM_GET_SWITCH_STATS
+ * x1	MPIDR of the cpu to report on
+ * x2	Path, one of TITANIUM_INSTR_PATH_*
+ * x3	First histogram bucket to report
+ *
+ * Return register usage:
+ * x0	0 on success, SMC_UNK on invalid arguments
+ * x1	Number of round trips along the path
+ * x2-7	Histogram buckets x3 to x3 + 5, bucket n counting the round trips
+ *	which spent [2^n, 2^(n+1)) counter ticks in EL3
+ */
+#define TEESMC_TITANIUM_FUNCID_GET_SWITCH_STATS		0xff00
+#define TEESMC_TITANIUM_GET_SWITCH_STATS \
+	TEESMC_TITANIUM_MONITOR64(TEESMC_TITANIUM_FUNCID_GET_SWITCH_STATS)
+
 #endif /*TEESMC_TITANIUM_H*/
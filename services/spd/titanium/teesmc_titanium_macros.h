@@ -14,4 +14,11 @@
 		 (62 << FUNCID_OEN_SHIFT) | \
 		 ((func_num) & FUNCID_NUM_MASK))
 
+/* Fast SMC64 issued by the normal world and handled by the dispatcher */
+#define TEESMC_TITANIUM_MONITOR64(func_num) \
+		((SMC_TYPE_FAST << FUNCID_TYPE_SHIFT) | \
+		 ((SMC_64) << FUNCID_CC_SHIFT) | \
+		 (62 << FUNCID_OEN_SHIFT) | \
+		 ((func_num) & FUNCID_NUM_MASK))
+
 #endif /* TEESMC_TITANIUM_MACROS_H */
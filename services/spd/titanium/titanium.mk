@@ -15,5 +15,50 @@ SPD_SOURCES		:=	services/spd/titanium/titanium_common.c	\
 
 NEED_BL32		:=	yes
 
-# required so that optee code can control access to the timer registers
-NS_TIMER_SWITCH		:=	1
+# Forward the KVM trap SMCs between the worlds from an assembly fast path in
+# smc_handler64 instead of going through titanium_smc_handler()
+TITANIUM_KVM_TRAP_FASTPATH	:=	0
+
+$(eval $(call assert_boolean,TITANIUM_KVM_TRAP_FASTPATH))
+$(eval $(call add_define,TITANIUM_KVM_TRAP_FASTPATH))
+
+# Forward the interrupts listed in PLAT_TITANIUM_LIGHT_FIQ_IDS to TITANIUM with
+# only the host EL2 registers switched
+TITANIUM_FIQ_LIGHT_PATH		:=	0
+
+$(eval $(call assert_boolean,TITANIUM_FIQ_LIGHT_PATH))
+$(eval $(call add_define,TITANIUM_FIQ_LIGHT_PATH))
+
+# Only switch the EL2 timer registers between the worlds if TITANIUM declares
+# that it uses the timer, with TEESMC_TITANIUM_ENTRY_FLAG_USES_TIMER in x2 of
+# TEESMC_TITANIUM_RETURN_ENTRY_DONE
+TITANIUM_LAZY_TIMER		:=	0
+
+$(eval $(call assert_boolean,TITANIUM_LAZY_TIMER))
+$(eval $(call add_define,TITANIUM_LAZY_TIMER))
+
+ifeq (${TITANIUM_LAZY_TIMER},0)
+    # required so that optee code can control access to the timer registers
+    NS_TIMER_SWITCH	:=	1
+endif
+
+# Pass x0-x17 of fast and yield calls to TITANIUM and return its results in
+# x0-x16, as SMCCC v1.2 allows, instead of x0-x7 and x0-x3
+TITANIUM_SMCCC_EXT_REGS		:=	0
+
+$(eval $(call assert_boolean,TITANIUM_SMCCC_EXT_REGS))
+$(eval $(call add_define,TITANIUM_SMCCC_EXT_REGS))
+
+# Timestamp the world switches of every TITANIUM path and keep per-cpu
+# histograms of the time spent in EL3, see titanium_instr.c
+TITANIUM_INSTRUMENTATION	:=	0
+
+$(eval $(call assert_boolean,TITANIUM_INSTRUMENTATION))
+$(eval $(call add_define,TITANIUM_INSTRUMENTATION))
+
+ifeq (${TITANIUM_INSTRUMENTATION},1)
+    ifneq (${ENABLE_RUNTIME_INSTRUMENTATION},1)
+        $(error TITANIUM_INSTRUMENTATION requires ENABLE_RUNTIME_INSTRUMENTATION)
+    endif
+    SPD_SOURCES		+=	services/spd/titanium/titanium_instr.c
+endif
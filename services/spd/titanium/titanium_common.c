@@ -97,12 +97,14 @@ uint64_t titanium_synchronous_sp_entry(titanium_context_t *titanium_ctx)
 	/* Apply the Secure EL2 system register context and switch to it */
 	assert(cm_get_context(SECURE) == &titanium_ctx->cpu_ctx);
 	cm_el2_sysregs_context_restore(SECURE, 0);
+	TITANIUM_FPREGS_SWITCH(SECURE);
 	cm_set_next_eret_context(SECURE);
 	
 	rc = titanium_enter_sp(&titanium_ctx->c_rt_ctx);
 #if ENABLE_ASSERTIONS
 	titanium_ctx->c_rt_ctx = 0;
 #endif
+	TITANIUM_FPREGS_SWITCH(NON_SECURE);
 
 	return rc;
 }
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ */
+
+/*******************************************************************************
+ * World switch instrumentation for the TITANIUM dispatcher. Every round trip
+ * from the normal world into TITANIUM and back is timestamped at four points:
+ * EL3 entry, ERET into the secure world, return from the secure world and the
+ * final ERET into the normal world. The timestamps are published through the
+ * PMF service PMF_TITANIUM_SVC_ID, while the time spent in EL3 for the whole
+ * round trip is accumulated into per-cpu log2 histograms which the normal
+ * world can read with TEESMC_TITANIUM_GET_SWITCH_STATS.
+ ******************************************************************************/
+#include <assert.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/runtime_svc.h>
+#include <lib/el3_runtime/cpu_data.h>
+#include <lib/pmf/pmf.h>
+#include <plat/common/platform.h>
+
+#include "titanium_private.h"
+
+/*******************************************************************************
+ * Per-cpu statistics.
+ * 'path'   - path of the round trip in flight, TITANIUM_INSTR_PATH_NONE if none
+ * 'ts'     - timestamps of the round trip in flight, indexed by point
+ * 'count'  - number of completed round trips per path
+ * 'hist'   - log2 histogram of the EL3 time of the completed round trips.
+ *            Bucket n counts round trips which took [2^n, 2^(n+1)) ticks,
+ *            bucket 0 also counts the ones which took no time at all.
+ ******************************************************************************/
+typedef struct titanium_instr_stats {
+	uint32_t path;
+	uint64_t ts[TITANIUM_INSTR_POINT_COUNT];
+	uint64_t count[TITANIUM_INSTR_PATH_COUNT];
+	uint32_t hist[TITANIUM_INSTR_PATH_COUNT][TITANIUM_INSTR_HIST_BUCKETS];
+} titanium_instr_stats_t;
+
+static titanium_instr_stats_t titanium_instr_stats[TITANIUM_CORE_COUNT];
+
+PMF_REGISTER_SERVICE_SMC(titanium_svc, PMF_TITANIUM_SVC_ID,
+	TITANIUM_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
+
+static void titanium_instr_record(titanium_instr_stats_t *stats,
+				  uint32_t point, uint64_t ts)
+{
+	stats->ts[point] = ts;
+	PMF_WRITE_TIMESTAMP(titanium_svc,
+			    TITANIUM_INSTR_TID(stats->path, point),
+			    PMF_NO_CACHE_MAINT,
+			    ts);
+}
+
+/*******************************************************************************
+ * Timestamp of the last entry into EL3 through an SMC, as captured by
+ * smc_handler64.
+ ******************************************************************************/
+uint64_t titanium_instr_smc_entry_ts(void)
+{
+	return get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]);
+}
+
+/*******************************************************************************
+ * Start timing a round trip along 'path' which entered EL3 at 'ts'.
+ ******************************************************************************/
+void titanium_instr_begin(uint32_t path, uint64_t ts)
+{
+	titanium_instr_stats_t *stats =
+		&titanium_instr_stats[plat_my_core_pos()];
+
+	assert(path < TITANIUM_INSTR_PATH_COUNT);
+
+	stats->path = path;
+	titanium_instr_record(stats, TITANIUM_INSTR_ENTER_EL3, ts);
+}
+
+/*******************************************************************************
+ * Record 'point' at time 'ts' for the round trip in flight on this cpu. The
+ * round trip is accounted for once the final ERET into the normal world has
+ * been recorded. Returns from the secure world which do not belong to a round
+ * trip started by the normal world e.g. PSCI completions are ignored.
+ ******************************************************************************/
+void titanium_instr_mark(uint32_t point, uint64_t ts)
+{
+	titanium_instr_stats_t *stats =
+		&titanium_instr_stats[plat_my_core_pos()];
+	uint64_t el3_ticks;
+	uint32_t bucket;
+
+	if (stats->path == TITANIUM_INSTR_PATH_NONE)
+		return;
+
+	titanium_instr_record(stats, point, ts);
+	if (point != TITANIUM_INSTR_ERET_NS)
+		return;
+
+	el3_ticks = (stats->ts[TITANIUM_INSTR_ERET_SECURE] -
+		     stats->ts[TITANIUM_INSTR_ENTER_EL3]) +
+		    (stats->ts[TITANIUM_INSTR_ERET_NS] -
+		     stats->ts[TITANIUM_INSTR_RETURN_SECURE]);
+
+	bucket = (el3_ticks == 0U) ? 0U : (63U - __builtin_clzll(el3_ticks));
+	if (bucket >= TITANIUM_INSTR_HIST_BUCKETS)
+		bucket = TITANIUM_INSTR_HIST_BUCKETS - 1U;
+
+	stats->count[stats->path]++;
+	stats->hist[stats->path][bucket]++;
+	stats->path = TITANIUM_INSTR_PATH_NONE;
+}
+
+/*******************************************************************************
+ * Handle TEESMC_TITANIUM_GET_SWITCH_STATS from the normal world.
+ * x1 - MPIDR of the cpu to report on
+ * x2 - path
+ * x3 - first histogram bucket to report
+ * On success x0 is 0, x1 holds the number of completed round trips along the
+ * path and x2-x7 hold the histogram buckets starting at x3. Buckets past the
+ * end of the histogram read as 0.
+ ******************************************************************************/
+uintptr_t titanium_instr_get_stats(u_register_t mpidr, u_register_t path,
+				   u_register_t first, void *handle)
+{
+	const titanium_instr_stats_t *stats;
+	uint64_t bkt[TITANIUM_INSTR_STATS_BUCKETS_PER_CALL] = { 0 };
+	int core_pos;
+	unsigned int i;
+
+	core_pos = plat_core_pos_by_mpidr(mpidr);
+	if ((core_pos < 0) || (path >= TITANIUM_INSTR_PATH_COUNT) ||
+	    (first >= TITANIUM_INSTR_HIST_BUCKETS))
+		SMC_RET1(handle, SMC_UNK);
+
+	stats = &titanium_instr_stats[core_pos];
+	for (i = 0U; i < TITANIUM_INSTR_STATS_BUCKETS_PER_CALL; i++) {
+		if ((first + i) < TITANIUM_INSTR_HIST_BUCKETS)
+			bkt[i] = stats->hist[path][first + i];
+	}
+
+	SMC_RET8(handle, SMC_OK, stats->count[path],
+		 bkt[0], bkt[1], bkt[2], bkt[3], bkt[4], bkt[5]);
+}
+
+/*******************************************************************************
+ * Mark every cpu as having no round trip in flight.
+ ******************************************************************************/
+void titanium_instr_init(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < TITANIUM_CORE_COUNT; i++)
+		titanium_instr_stats[i].path = TITANIUM_INSTR_PATH_NONE;
+}
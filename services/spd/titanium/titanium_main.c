@@ -23,11 +23,14 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/runtime_svc.h>
+#include <drivers/arm/gicv3.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/psci/psci_cmo.h>
 #include <plat/common/platform.h>
 #include <tools_share/uuid.h>
 
 #include "titanium_private.h"
+#include "titanium_shm_ring.h"
 #include "teesmc_titanium.h"
 #include "teesmc_titanium_macros.h"
 
@@ -41,6 +44,7 @@ struct titanium_vectors *titanium_vector_table;
  * Array to keep track of per-cpu TITANIUM state
  ******************************************************************************/
 titanium_context_t titanium_sp_context[TITANIUM_CORE_COUNT];
+REGISTER_PSCI_CMO_PERCPU_ARRAY(titanium_sp_context);
 uint32_t titanium_rw;
 
 static int32_t titanium_init(void);
@@ -65,16 +69,6 @@ void read_curEL_with_string(char *s){
 	printf("The CurrentEL.EL %s is : %lu\n", s, data);
 }
 
-void cm_set_sre_el1(uint32_t security_state, uint64_t sre_value)
-{
-	cpu_context_t *ctx;
-
-	ctx = cm_get_context(security_state);
-	assert(ctx != NULL);
-
-	ctx->icc_sre_el1 = sre_value;
-}
-
 
 /*******************************************************************************
  * This function retrieves vbar_el2 member of 'cpu_context' pertaining to the
@@ -97,10 +91,48 @@ uint64_t cm_get_vbar_el2(uint32_t security_state)
 
 //SPD: Secure Payload Dispatcher
 
+#if TITANIUM_FIQ_LIGHT_PATH
+#ifndef PLAT_TITANIUM_LIGHT_FIQ_IDS
+#error "TITANIUM_FIQ_LIGHT_PATH requires PLAT_TITANIUM_LIGHT_FIQ_IDS"
+#endif
+
+/*******************************************************************************
+ * Interrupts which TITANIUM is expected to handle quickly e.g. the secure
+ * timer and doorbells. They enter TITANIUM with only the host EL2 registers
+ * switched, see titanium_get_fiq_policy().
+ ******************************************************************************/
+static const unsigned int titanium_light_fiq_ids[] = {
+	PLAT_TITANIUM_LIGHT_FIQ_IDS
+};
+#endif
+
+/*******************************************************************************
+ * Look up how the interrupt 'id' is forwarded to TITANIUM. Unknown and
+ * spurious interrupts always get a full world switch.
+ ******************************************************************************/
+static uint32_t titanium_get_fiq_policy(unsigned int id)
+{
+#if TITANIUM_FIQ_LIGHT_PATH
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(titanium_light_fiq_ids); i++) {
+		if (titanium_light_fiq_ids[i] == id)
+			return TITANIUM_FIQ_LIGHT;
+	}
+#endif
+
+	return TITANIUM_FIQ_FULL;
+}
+
 /*******************************************************************************
  * This function is the handler registered for S-EL1 interrupts by the
  * TITANIUM. It validates the interrupt and upon success arranges entry into
  * the TITANIUM at 'titanium_fiq_entry()' for handling the interrupt.
+ *
+ * Interrupts with the TITANIUM_FIQ_LIGHT policy only switch the host EL2
+ * registers, like the KVM traps do. TITANIUM learns the policy in x1 and
+ * must issue TEESMC_TITANIUM_FIQ_FULL_SWITCH before touching any other EL2
+ * register.
  ******************************************************************************/
 static uint64_t titanium_sel2_interrupt_handler(uint32_t id,
 					    uint32_t flags,
@@ -108,6 +140,7 @@ static uint64_t titanium_sel2_interrupt_handler(uint32_t id,
 					    void *cookie)
 {
 	uint32_t linear_id;
+	uint32_t is_light;
 	titanium_context_t *titanium_ctx;
 
 	/* Check the security state when the exception was generated */
@@ -116,17 +149,25 @@ static uint64_t titanium_sel2_interrupt_handler(uint32_t id,
 	/* Sanity check the pointer to this cpu's context */
 	assert(handle == cm_get_context(NON_SECURE));
 
-	/* Save the non-secure context before entering the TITANIUM */
-	cm_el2_sysregs_context_save(NON_SECURE, 0);
+	TITANIUM_INSTR_BEGIN_NOW(TITANIUM_INSTR_PATH_FIQ);
 
 	/* Get a reference to this cpu's TITANIUM context */
 	linear_id = plat_my_core_pos();
 	titanium_ctx = &titanium_sp_context[linear_id];
 	assert(&titanium_ctx->cpu_ctx == cm_get_context(SECURE));
 
+	titanium_ctx->fiq_policy =
+		titanium_get_fiq_policy(plat_ic_get_pending_interrupt_id());
+	is_light = (titanium_ctx->fiq_policy == TITANIUM_FIQ_LIGHT) ? 1U : 0U;
+
+	/* Save the non-secure context before entering the TITANIUM */
+	cm_el2_sysregs_context_save(NON_SECURE, is_light);
+
 	cm_set_elr_el3(SECURE, (uint64_t)&titanium_vector_table->fiq_entry);
-	cm_el2_sysregs_context_restore(SECURE, 0);
+	cm_el2_sysregs_context_restore(SECURE, is_light);
+	TITANIUM_FPREGS_SWITCH(SECURE);
 	cm_set_next_eret_context(SECURE);
+	TITANIUM_INSTR_MARK(TITANIUM_INSTR_ERET_SECURE);
 
 	/*read_actlr_el2
 	 * Tell the TITANIUM that it has to handle an FIQ (synchronously).
@@ -135,7 +176,8 @@ static uint64_t titanium_sel2_interrupt_handler(uint32_t id,
 	 * retrieve this address from ELR_EL3 as the secure context will
 	 * not take effect until el3_exit().
 	 */
-	SMC_RET1(&titanium_ctx->cpu_ctx, read_elr_el3());
+	SMC_RET2(&titanium_ctx->cpu_ctx, read_elr_el3(),
+		 titanium_ctx->fiq_policy);
 }
 
 /*******************************************************************************
@@ -198,6 +240,10 @@ static int32_t titanium_setup(void)
 				dt_addr,
 				&titanium_sp_context[linear_id]);
 
+#if TITANIUM_INSTRUMENTATION
+	titanium_instr_init();
+#endif
+
 	/*
 	 * All TITANIUM initialization done. Now register our init function with
 	 * BL31 for deferred invocation
@@ -257,8 +303,6 @@ static int32_t titanium_init(void)
 	return rc;
 }
 
-long enter_titanium_count = 0;
-long leave_titanium_count = 0;
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
  * range from the non-secure state as defined in the SMC Calling Convention
@@ -283,12 +327,11 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 	uint32_t linear_id = plat_my_core_pos();
 	titanium_context_t *titanium_ctx = &titanium_sp_context[linear_id];
 	uint64_t rc;
-	uint32_t icc_sre_el1;
 	/*
 	 * Determine which security state this SMC originated from
 	 */
 
-	smc_imm = read_esr_el3() & 0xffff;
+	smc_imm = read_esr_el3() & SMC_IMM_MASK;
 
 	if (smc_imm != 0) {
 		is_kvm_trap = 1;
@@ -304,16 +347,28 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
+#if TITANIUM_INSTRUMENTATION
+		/* Answered by the dispatcher without entering TITANIUM */
+		if ((is_kvm_trap == 0) &&
+		    (smc_fid == TEESMC_TITANIUM_GET_SWITCH_STATS))
+			return titanium_instr_get_stats(x1, x2, x3, handle);
+#endif
+
+		/*
+		 * A batch cannot hold more requests than a submission ring,
+		 * reject it without entering TITANIUM.
+		 */
+		if ((smc_imm == SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_BATCH) &&
+		    ((x1 == 0U) || (x1 > TITANIUM_SHM_RING_ENTRIES)))
+			SMC_RET1(handle, SMC_UNK);
+
 		if (is_kvm_trap == 1) {
 			cm_el2_sysregs_context_save(NON_SECURE, 1);
 
-			icc_sre_el1 = (uint32_t)read_icc_sre_el1();
-			icc_sre_el1 &= ~(1UL);  //clear SRE bit
-//			write_icc_sre_el1(icc_sre_el1);
-			cm_set_sre_el1(SECURE, (uint64_t)icc_sre_el1);
-
+			/* TITANIUM runs with the system register interface disabled */
+			cm_defer_sysreg_write(SECURE, CTX_DEFER_ICC_SRE_EL1,
+					      read_icc_sre_el1() & ~ICC_SRE_SRE_BIT);
 		} else {
-			cm_set_sre_el1(SECURE, 0);
 			cm_el2_sysregs_context_save(NON_SECURE, 0);
 		}
 
@@ -337,24 +392,34 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 		if (is_kvm_trap == 1) {
 			switch (smc_imm) {
 				case SMC_IMM_KVM_TO_TITANIUM_TRAP:
+					TITANIUM_INSTR_BEGIN(TITANIUM_INSTR_PATH_KVM_TRAP);
 					cm_set_elr_el3(SECURE, (uint64_t)
 						&titanium_vector_table->kvm_trap_smc_entry);
 					break;
 				case SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_REGISTER:
+					TITANIUM_INSTR_BEGIN(TITANIUM_INSTR_PATH_SHM_REGISTER);
 					cm_set_elr_el3(SECURE, (uint64_t)
 						&titanium_vector_table->kvm_shared_memory_register_entry);
 					break;
 				case SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_HANDLE:
+					TITANIUM_INSTR_BEGIN(TITANIUM_INSTR_PATH_SHM_HANDLE);
 					cm_set_elr_el3(SECURE, (uint64_t)
 						&titanium_vector_table->kvm_shared_memory_handle_entry);
 					break;
+				case SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_BATCH:
+					TITANIUM_INSTR_BEGIN(TITANIUM_INSTR_PATH_SHM_BATCH);
+					cm_set_elr_el3(SECURE, (uint64_t)
+						&titanium_vector_table->kvm_shared_memory_batch_entry);
+					break;
 				default:
 					panic();
 			}
 		} else if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST) {
+			TITANIUM_INSTR_BEGIN(TITANIUM_INSTR_PATH_FAST);
 			cm_set_elr_el3(SECURE, (uint64_t)
 					&titanium_vector_table->fast_smc_entry);
 		} else {
+			TITANIUM_INSTR_BEGIN(TITANIUM_INSTR_PATH_YIELD);
 			cm_set_elr_el3(SECURE, (uint64_t)
 					&titanium_vector_table->yield_smc_entry);
 		}
@@ -366,23 +431,37 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 			cm_el2_sysregs_context_restore(SECURE, 0);
 		}
 
+		TITANIUM_FPREGS_SWITCH(SECURE);
 		cm_set_next_eret_context(SECURE);
 
 		if (is_kvm_trap == 1) {
 			switch (smc_imm) {
 				case SMC_IMM_KVM_TO_TITANIUM_TRAP:
 				case SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_REGISTER:
-					memcpy(get_gpregs_ctx(&titanium_ctx->cpu_ctx),
-						get_gpregs_ctx(handle), sizeof(gp_regs_t));
+					titanium_handoff_gpregs(
+						get_gpregs_ctx(&titanium_ctx->cpu_ctx),
+						get_gpregs_ctx(handle));
 					break;
 				case SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_HANDLE:
 					break;
+				case SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_BATCH:
+					/* Number of requests queued in the submission ring */
+					write_ctx_reg(get_gpregs_ctx(&titanium_ctx->cpu_ctx),
+							CTX_GPREG_X1, x1);
+					break;
 				default:
 					panic();
 			}
 
+			TITANIUM_INSTR_MARK(TITANIUM_INSTR_ERET_SECURE);
 			SMC_RET0(&titanium_ctx->cpu_ctx);
 		} else {
+#if TITANIUM_SMCCC_EXT_REGS
+			/* x4-x17 as in SMCCC v1.2, including the client ID */
+			titanium_handoff_call_args(
+				get_gpregs_ctx(&titanium_ctx->cpu_ctx),
+				get_gpregs_ctx(handle));
+#else
 			write_ctx_reg(get_gpregs_ctx(&titanium_ctx->cpu_ctx),
 					CTX_GPREG_X4,
 					read_ctx_reg(get_gpregs_ctx(handle),
@@ -400,17 +479,16 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 					CTX_GPREG_X7,
 					read_ctx_reg(get_gpregs_ctx(handle),
 						CTX_GPREG_X7));
-
+#endif
 		}
+		TITANIUM_INSTR_MARK(TITANIUM_INSTR_ERET_SECURE);
 		SMC_RET4(&titanium_ctx->cpu_ctx, smc_fid, x1, x2, x3);
 	}
 
 	/*
 	 * Returning from TITANIUM
 	 */
-
-	/* set this value to 0 to let el3_exit to not change ICC_SRE_EL1 */
-	cm_set_sre_el1(NON_SECURE, 0);
+	TITANIUM_INSTR_MARK_SECURE_RETURN();
 
 	if (is_kvm_trap == 1) {
 		cm_el2_sysregs_context_save(SECURE, 1);
@@ -419,26 +497,31 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
 
-		/* Restore icc_sre_el1 and set SRE value */
-		cm_set_sre_el1(NON_SECURE, 0);
-
 		/* Restore non-secure state */
 		cm_el2_sysregs_context_restore(NON_SECURE, 1);
+		TITANIUM_FPREGS_SWITCH(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
 		switch (smc_imm) {
 			case SMC_IMM_TITANIUM_TO_KVM_TRAP_SYNC: case SMC_IMM_TITANIUM_TO_KVM_TRAP_IRQ:
-				memcpy(get_gpregs_ctx(ns_cpu_context), get_gpregs_ctx(handle), sizeof(gp_regs_t));
+				titanium_handoff_gpregs(get_gpregs_ctx(ns_cpu_context),
+							get_gpregs_ctx(handle));
 				cm_set_elr_el3(NON_SECURE, (uint64_t)cm_get_vbar_el2(NON_SECURE) + (8+exit_value) * 0x80);//skip the first eight handler
 				break;
 			case SMC_IMM_TITANIUM_TO_KVM_SHARED_MEMORY:
 				//printf("jump away from save titanium registers\n");
 				//printf("jump away from redirect elr registers to vbar addr\n");
 				break;
+			case SMC_IMM_TITANIUM_TO_KVM_SHARED_MEMORY_BATCH:
+				/* Number of responses queued in the completion ring */
+				write_ctx_reg(get_gpregs_ctx(ns_cpu_context),
+						CTX_GPREG_X0, x1);
+				break;
 			default:
 				panic();
 		}
 
 //		cm_set_elr_el3(NON_SECURE, (uint64_t)cm_get_elr_el3(NON_SECURE));
+		TITANIUM_INSTR_MARK(TITANIUM_INSTR_ERET_NS);
 		SMC_RET0(ns_cpu_context);
 	}
 
@@ -457,6 +540,27 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 			if (titanium_vector_table) {
 				set_titanium_pstate(titanium_ctx->state, TITANIUM_PSTATE_ON);
 
+#if TITANIUM_LAZY_TIMER
+				/*
+				 * Leave the EL2 timer registers to the normal
+				 * world unless TITANIUM has declared that it
+				 * programs the timer.
+				 */
+				if ((x2 & TEESMC_TITANIUM_ENTRY_FLAG_USES_TIMER) == 0U)
+					cm_el2_sysregs_set_switched_grps(
+						CTX_EL2_GRPS_ALL &
+						~CTX_EL2_GRP_BIT(CTX_EL2_GRP_TIMER));
+#endif
+
+#if TITANIUM_KVM_TRAP_FASTPATH
+				/*
+				 * Let smc_handler64 forward KVM traps without
+				 * entering this handler from now on.
+				 */
+				titanium_kvm_trap_entry = (uintptr_t)
+					&titanium_vector_table->kvm_trap_smc_entry;
+#endif
+
 				/*
 				 * TITANIUM has been successfully initialized.
 				 * Register power management hooks with PSCI
@@ -540,8 +644,15 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 
 			/* Restore non-secure state */
 			cm_el2_sysregs_context_restore(NON_SECURE, 0);
+			TITANIUM_FPREGS_SWITCH(NON_SECURE);
 			cm_set_next_eret_context(NON_SECURE);
 
+#if TITANIUM_SMCCC_EXT_REGS
+			/* Results in x0-x16, from x1-x17 of TITANIUM */
+			titanium_handoff_call_results(get_gpregs_ctx(ns_cpu_context),
+						      get_gpregs_ctx(handle));
+#endif
+			TITANIUM_INSTR_MARK(TITANIUM_INSTR_ERET_NS);
 			SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
 
 			/*
@@ -558,11 +669,36 @@ static uintptr_t titanium_smc_handler(uint32_t smc_fid,
 			 * secure system register context since TITANIUM was supposed
 			 * to preserve it during S-EL1 interrupt handling.
 			 */
-			cm_el2_sysregs_context_restore(NON_SECURE, 0);
+			cm_el2_sysregs_context_restore(NON_SECURE,
+				(titanium_ctx->fiq_policy == TITANIUM_FIQ_LIGHT) ?
+				1U : 0U);
+			titanium_ctx->fiq_policy = TITANIUM_FIQ_FULL;
+			TITANIUM_FPREGS_SWITCH(NON_SECURE);
 			cm_set_next_eret_context(NON_SECURE);
 
+			TITANIUM_INSTR_MARK(TITANIUM_INSTR_ERET_NS);
 			SMC_RET0((uint64_t) ns_cpu_context);
 
+			/*
+			 * TITANIUM needs more than the host EL2 registers to
+			 * handle an FIQ which it entered with TITANIUM_FIQ_LIGHT.
+			 * Put the normal world host registers back, complete the
+			 * full switch and resume TITANIUM after its SMC.
+			 */
+		case TEESMC_TITANIUM_FIQ_FULL_SWITCH:
+			assert(handle == cm_get_context(SECURE));
+
+			if (titanium_ctx->fiq_policy == TITANIUM_FIQ_LIGHT) {
+				cm_el2_sysregs_context_save(SECURE, 1);
+				cm_el2_sysregs_context_restore(NON_SECURE, 1);
+				cm_el2_sysregs_context_save(NON_SECURE, 0);
+				cm_el2_sysregs_context_restore(SECURE, 0);
+				titanium_ctx->fiq_policy = TITANIUM_FIQ_FULL;
+			}
+
+			cm_set_next_eret_context(SECURE);
+			SMC_RET1(handle, SMC_OK);
+
 		default:
 			panic();
 	}
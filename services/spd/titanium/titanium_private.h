@@ -34,6 +34,13 @@
 				} while (0)
 
 
+/*******************************************************************************
+ * How an interrupt is forwarded to TITANIUM: with a full EL2 world switch or
+ * with only the host EL2 registers switched, see titanium_get_fiq_policy()
+ ******************************************************************************/
+#define TITANIUM_FIQ_FULL		0
+#define TITANIUM_FIQ_LIGHT		1
+
 /*******************************************************************************
  * TITANIUM execution state information i.e. aarch32 or aarch64
  ******************************************************************************/
@@ -79,18 +86,63 @@
 #define TITANIUM_C_RT_CTX_SIZE		0x60
 #define TITANIUM_C_RT_CTX_ENTRIES		(TITANIUM_C_RT_CTX_SIZE >> DWORD_SHIFT)
 
-#ifndef __ASSEMBLER__
-
-#include <stdint.h>
-
-#include <lib/cassert.h>
-
+/*******************************************************************************
+ * SMC immediates used by KVM and TITANIUM to forward traps and shared memory
+ * requests between the two worlds
+ ******************************************************************************/
 #define SMC_IMM_KVM_TO_TITANIUM_TRAP 0x1
 #define SMC_IMM_TITANIUM_TO_KVM_TRAP_SYNC 0x1
 #define SMC_IMM_TITANIUM_TO_KVM_TRAP_IRQ 0x2
 #define SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_REGISTER 0x10
 #define SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_HANDLE 0x18
 #define SMC_IMM_TITANIUM_TO_KVM_SHARED_MEMORY 0x10
+#define SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_BATCH 0x20
+#define SMC_IMM_TITANIUM_TO_KVM_SHARED_MEMORY_BATCH 0x20
+#define SMC_IMM_MASK			0xffff
+
+/*
+ * KVM trap vectors in the normal world hypervisor start after the eight
+ * architectural exception vectors, each of which is 0x80 bytes in size
+ */
+#define TITANIUM_KVM_TRAP_VECTOR_BASE	8
+#define TITANIUM_KVM_VECTOR_SHIFT	7
+
+/*******************************************************************************
+ * World switch instrumentation. Each round trip from the normal world into
+ * TITANIUM is timestamped at four points, which are published through the PMF
+ * service PMF_TITANIUM_SVC_ID with the timestamp ID (path << 2 | point).
+ ******************************************************************************/
+#define TITANIUM_INSTR_PATH_FAST		U(0)
+#define TITANIUM_INSTR_PATH_YIELD		U(1)
+#define TITANIUM_INSTR_PATH_KVM_TRAP		U(2)
+#define TITANIUM_INSTR_PATH_SHM_REGISTER	U(3)
+#define TITANIUM_INSTR_PATH_SHM_HANDLE		U(4)
+#define TITANIUM_INSTR_PATH_FIQ			U(5)
+#define TITANIUM_INSTR_PATH_SHM_BATCH		U(6)
+#define TITANIUM_INSTR_PATH_COUNT		U(7)
+#define TITANIUM_INSTR_PATH_NONE		U(0xff)
+
+#define TITANIUM_INSTR_ENTER_EL3		U(0)
+#define TITANIUM_INSTR_ERET_SECURE		U(1)
+#define TITANIUM_INSTR_RETURN_SECURE		U(2)
+#define TITANIUM_INSTR_ERET_NS			U(3)
+#define TITANIUM_INSTR_POINT_COUNT		U(4)
+
+#define TITANIUM_INSTR_TID(path, point)		(((path) << 2) | (point))
+#define TITANIUM_INSTR_TOTAL_IDS		(TITANIUM_INSTR_PATH_COUNT * \
+						 TITANIUM_INSTR_POINT_COUNT)
+
+/* Number of log2 buckets of the per-cpu, per-path EL3 time histograms */
+#define TITANIUM_INSTR_HIST_BUCKETS		U(32)
+/* TEESMC_TITANIUM_GET_SWITCH_STATS returns buckets in x2-x7 */
+#define TITANIUM_INSTR_STATS_BUCKETS_PER_CALL	U(6)
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#include <lib/cassert.h>
+#include <lib/pmf/pmf.h>
 
 
 typedef uint32_t titanium_vector_isn_t;
@@ -108,6 +160,7 @@ typedef struct titanium_vectors {
 	titanium_vector_isn_t fiq_entry;
 	titanium_vector_isn_t system_off_entry;
 	titanium_vector_isn_t system_reset_entry;
+	titanium_vector_isn_t kvm_shared_memory_batch_entry;
 } titanium_vectors_t;
 
 /*
@@ -116,6 +169,13 @@ typedef struct titanium_vectors {
  */
 #define TITANIUM_NUM_ARGS	0x2
 
+/*
+ * titanium_handoff_gpregs() moves the whole general purpose register frame,
+ * which must end with the LR and SP_EL0 pair.
+ */
+CASSERT((CTX_GPREG_LR + 0x10) == sizeof(gp_regs_t),	\
+	assert_titanium_gpregs_handoff_size_mismatch);
+
 /* AArch64 callee saved general purpose register context structure. */
 DEFINE_REG_STRUCT(c_rt_regs, TITANIUM_C_RT_CTX_ENTRIES);
 
@@ -129,18 +189,30 @@ CASSERT(TITANIUM_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
 
 /*******************************************************************************
  * Structure which helps the TITANIUM to maintain the per-cpu state of TITANIUM.
+ * 'cpu_ctx'        - space to maintain TITANIUM architectural state
  * 'state'          - collection of flags to track TITANIUM state e.g. on/off
  * 'mpidr'          - mpidr to associate a context with a cpu
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into TITANIUM.
- * 'cpu_ctx'        - space to maintain TITANIUM architectural state
+ * 'fiq_policy'     - how the FIQ being handled by TITANIUM was forwarded
+ *
+ * Like 'cpu_data', each context starts on a cache line boundary so that cpus
+ * handling SMCs concurrently do not share lines. 'cpu_ctx' comes first so that
+ * the general purpose registers accessed on every EL3 entry and exit are line
+ * aligned too.
  ******************************************************************************/
 typedef struct titanium_context {
+	cpu_context_t cpu_ctx;
 	uint32_t state;
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
-	cpu_context_t cpu_ctx;
-} titanium_context_t;
+	uint32_t fiq_policy;
+} __aligned(CACHE_WRITEBACK_GRANULE) titanium_context_t;
+
+CASSERT(__builtin_offsetof(titanium_context_t, cpu_ctx) == 0U,	\
+	assert_titanium_cpu_ctx_offset_mismatch);
+CASSERT((sizeof(titanium_context_t) % CACHE_WRITEBACK_GRANULE) == 0U,	\
+	assert_titanium_context_size_not_cache_line_multiple);
 
 /* TITANIUM power management handlers */
 extern const spd_pm_ops_t titanium_pm;
@@ -154,6 +226,11 @@ struct titanium_vectors;
  * Function & Data prototypes
  ******************************************************************************/
 uint64_t titanium_enter_sp(uint64_t *c_rt_ctx);
+void titanium_handoff_gpregs(gp_regs_t *dst, const gp_regs_t *src);
+#if TITANIUM_SMCCC_EXT_REGS
+void titanium_handoff_call_args(gp_regs_t *dst, const gp_regs_t *src);
+void titanium_handoff_call_results(gp_regs_t *dst, const gp_regs_t *src);
+#endif
 void __dead2 titanium_exit_sp(uint64_t c_rt_ctx, uint64_t ret);
 uint64_t titanium_synchronous_sp_entry(titanium_context_t *titanium_ctx);
 void __dead2 titanium_synchronous_sp_exit(titanium_context_t *titanium_ctx, uint64_t ret);
@@ -165,9 +242,56 @@ void titanium_init_titanium_ep_state(struct entry_point_info *titanium_entry_poi
 				uint64_t dt_addr,
 				titanium_context_t *titanium_ctx);
 
+#if TITANIUM_KVM_TRAP_FASTPATH
+void titanium_kvm_trap_fastpath(void);
+#endif
+
+#if TITANIUM_INSTRUMENTATION
+PMF_DECLARE_CAPTURE_TIMESTAMP(titanium_svc)
+PMF_DECLARE_GET_TIMESTAMP(titanium_svc)
+
+void titanium_instr_init(void);
+uint64_t titanium_instr_smc_entry_ts(void);
+void titanium_instr_begin(uint32_t path, uint64_t ts);
+void titanium_instr_mark(uint32_t point, uint64_t ts);
+uintptr_t titanium_instr_get_stats(u_register_t mpidr, u_register_t path,
+				   u_register_t first, void *handle);
+
+#define TITANIUM_INSTR_BEGIN(_path)					\
+	titanium_instr_begin((_path), titanium_instr_smc_entry_ts())
+#define TITANIUM_INSTR_BEGIN_NOW(_path)					\
+	titanium_instr_begin((_path), read_cntpct_el0())
+#define TITANIUM_INSTR_MARK(_point)					\
+	titanium_instr_mark((_point), read_cntpct_el0())
+#define TITANIUM_INSTR_MARK_SECURE_RETURN()				\
+	titanium_instr_mark(TITANIUM_INSTR_RETURN_SECURE,		\
+			    titanium_instr_smc_entry_ts())
+#else
+#define TITANIUM_INSTR_BEGIN(_path)
+#define TITANIUM_INSTR_BEGIN_NOW(_path)
+#define TITANIUM_INSTR_MARK(_point)
+#define TITANIUM_INSTR_MARK_SECURE_RETURN()
+#endif
+
+/*
+ * Hand the FP/SIMD registers over to the world about to be entered with
+ * CTX_FPREGS_LAZY, which only changes CPTR_EL3.TFP. Otherwise the registers
+ * are shared by the worlds, as Titanium has always done, and an eager
+ * save/restore of the whole bank on every switch is not worth its cost.
+ */
+#if CTX_FPREGS_LAZY
+#define TITANIUM_FPREGS_SWITCH(_security_state)				\
+	cm_fpregs_context_switch(_security_state)
+#else
+#define TITANIUM_FPREGS_SWITCH(_security_state)
+#endif
+
 extern titanium_context_t titanium_sp_context[TITANIUM_CORE_COUNT];
 extern uint32_t titanium_rw;
 extern struct titanium_vectors *titanium_vector_table;
+#if TITANIUM_KVM_TRAP_FASTPATH
+extern uintptr_t titanium_kvm_trap_entry;
+#endif
 #endif /*__ASSEMBLER__*/
 
 #endif /* TITANIUM_PRIVATE_H */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ */
+
+#ifndef TITANIUM_SHM_RING_H
+#define TITANIUM_SHM_RING_H
+
+#include <lib/utils_def.h>
+
+/*******************************************************************************
+ * Layout of the batched request rings in the shared memory registered with
+ * SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_REGISTER.
+ *
+ * Every cpu owns one submission ring and one completion ring, both of which
+ * are single-producer/single-consumer and lock free:
+ * - the normal world hypervisor produces requests into the submission ring
+ *   and consumes responses from the completion ring of the cpu it runs on,
+ * - TITANIUM consumes requests and produces responses on the same cpu.
+ *
+ * 'head' is only written by the producer and 'tail' only by the consumer.
+ * Both are free running and reduced modulo TITANIUM_SHM_RING_ENTRIES when
+ * indexing 'desc'. A producer fills desc[head % entries] and then publishes
+ * it with a store-release of head + 1; a consumer load-acquires head, reads
+ * the descriptors up to it and then releases them with a store-release of the
+ * new tail. A ring is full when head - tail == TITANIUM_SHM_RING_ENTRIES.
+ *
+ * Once it has queued N requests, the hypervisor issues a single
+ * SMC_IMM_KVM_TO_TITANIUM_SHARED_MEMORY_BATCH with N in x1. The dispatcher
+ * enters TITANIUM once at 'kvm_shared_memory_batch_entry' with N in x1, and
+ * TITANIUM returns with SMC_IMM_TITANIUM_TO_KVM_SHARED_MEMORY_BATCH and the
+ * number of responses it produced in x1, which the hypervisor gets in x0.
+ ******************************************************************************/
+#define TITANIUM_SHM_RING_ENTRIES	U(64)
+#define TITANIUM_SHM_DESC_ARGS		U(7)
+
+#define TITANIUM_SHM_DESC_SIZE		U(0x40)
+#define TITANIUM_SHM_RING_IDX_SIZE	U(0x40)
+#define TITANIUM_SHM_RING_SIZE		((2U * TITANIUM_SHM_RING_IDX_SIZE) + \
+					 (TITANIUM_SHM_RING_ENTRIES * \
+					  TITANIUM_SHM_DESC_SIZE))
+#define TITANIUM_SHM_CPU_RINGS_SIZE	(2U * TITANIUM_SHM_RING_SIZE)
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#include <lib/cassert.h>
+
+/* One request or response, occupying a cache line of its own */
+typedef struct titanium_shm_desc {
+	uint64_t op;
+	uint64_t args[TITANIUM_SHM_DESC_ARGS];
+} titanium_shm_desc_t;
+
+/* Indices are kept on separate cache lines to avoid false sharing */
+typedef struct titanium_shm_ring {
+	uint32_t head;
+	uint8_t head_pad[TITANIUM_SHM_RING_IDX_SIZE - sizeof(uint32_t)];
+	uint32_t tail;
+	uint8_t tail_pad[TITANIUM_SHM_RING_IDX_SIZE - sizeof(uint32_t)];
+	titanium_shm_desc_t desc[TITANIUM_SHM_RING_ENTRIES];
+} titanium_shm_ring_t;
+
+typedef struct titanium_shm_cpu_rings {
+	titanium_shm_ring_t submit;
+	titanium_shm_ring_t complete;
+} titanium_shm_cpu_rings_t;
+
+CASSERT((TITANIUM_SHM_RING_ENTRIES & (TITANIUM_SHM_RING_ENTRIES - 1U)) == 0U,
+	assert_titanium_shm_ring_entries_not_power_of_2);
+CASSERT(sizeof(titanium_shm_desc_t) == TITANIUM_SHM_DESC_SIZE,
+	assert_titanium_shm_desc_size_mismatch);
+CASSERT(sizeof(titanium_shm_ring_t) == TITANIUM_SHM_RING_SIZE,
+	assert_titanium_shm_ring_size_mismatch);
+CASSERT(sizeof(titanium_shm_cpu_rings_t) == TITANIUM_SHM_CPU_RINGS_SIZE,
+	assert_titanium_shm_cpu_rings_size_mismatch);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TITANIUM_SHM_RING_H */
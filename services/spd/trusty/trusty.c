@@ -24,6 +24,11 @@
 #include "sm_err.h"
 #include "smcall.h"
 
+/* Trusty saves and restores the FP/SIMD registers on every world switch */
+#if CTX_FPREGS_LAZY
+#error "Trusty does not support CTX_FPREGS_LAZY"
+#endif
+
 /* Trusty UID: RFC-4122 compliant UUID version 4 */
 DEFINE_SVC_UUID2(trusty_uuid,
 		 0x40ee25f0, 0xa2bc, 0x304c, 0x8c, 0x4c,
@@ -53,7 +58,7 @@ struct trusty_cpu_ctx {
 	uint64_t	fiq_sp_el1;
 	gp_regs_t	fiq_gpregs;
 	struct trusty_stack	secure_stack;
-};
+} __aligned(CACHE_WRITEBACK_GRANULE);
 
 struct smc_args {
 	uint64_t	r0;
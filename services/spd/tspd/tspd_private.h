@@ -190,7 +190,7 @@ typedef struct tsp_context {
 	sp_ctx_regs_t sp_ctx;
 	bool preempted_by_sel1_intr;
 #endif
-} tsp_context_t;
+} __aligned(CACHE_WRITEBACK_GRANULE) tsp_context_t;
 
 /* Helper macros to store and retrieve tsp args from tsp_context */
 #define store_tsp_args(_tsp_ctx, _x1, _x2)		do {\
@@ -30,12 +30,225 @@ static uuid_t arm_svc_uid = {
 	{0xc0, 0xfb, 0x56, 0x41, 0xf6, 0xe2}
 };
 
+/* Prototype of the PSCI SMC handlers */
+typedef u_register_t (*std_svc_psci_handle_t)(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags);
+
+/*
+ * Dispatch PSCI calls to the PSCI SMC handler 'psci_handler' and return its
+ * return value
+ */
+static inline uintptr_t std_svc_psci_call(std_svc_psci_handle_t psci_handler,
+			     uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	uint64_t ret;
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+
+	/*
+	 * Flush cache line so that even if CPU power down happens
+	 * the timestamp update is reflected in memory.
+	 */
+	PMF_WRITE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_PSCI,
+	    PMF_CACHE_MAINT,
+	    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
+#endif
+
+	ret = psci_handler(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_PSCI,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	SMC_RET1(handle, ret);
+}
+
+static uintptr_t std_svc_psci_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	return std_svc_psci_call(psci_smc_handler, smc_fid, x1, x2, x3, x4,
+				 cookie, handle, flags);
+}
+
+static uintptr_t std_svc_psci_cpu_suspend_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	return std_svc_psci_call(psci_cpu_suspend_smc_handler, smc_fid,
+				 x1, x2, x3, x4, cookie, handle, flags);
+}
+
+#if SPM_MM
+/*
+ * Dispatch SPM calls to SPM SMC handler and return its return
+ * value
+ */
+static uintptr_t std_svc_spm_mm_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	return spm_mm_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				  handle, flags);
+}
+#endif
+
+#if defined(SPD_spmd)
+/*
+ * Dispatch FFA calls to the FFA SMC handler implemented by the SPM
+ * dispatcher and return its return value
+ */
+static uintptr_t std_svc_ffa_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	return spmd_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				handle, flags);
+}
+#endif
+
+#if SDEI_SUPPORT
+static uintptr_t std_svc_sdei_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	/* SDEI calls are SMC64 only */
+	if (!is_sdei_fid(smc_fid)) {
+		WARN("Unimplemented Standard Service Call: 0x%x \n", smc_fid);
+		SMC_RET1(handle, SMC_UNK);
+	}
+
+	return sdei_smc_handler(smc_fid, x1, x2, x3, x4, cookie, handle,
+			flags);
+}
+#endif
+
+static uintptr_t std_svc_query_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	switch (smc_fid) {
+	case ARM_STD_SVC_CALL_COUNT:
+		/*
+		 * Return the number of Standard Service Calls. PSCI is the only
+		 * standard service implemented; so return number of PSCI calls
+		 */
+		SMC_RET1(handle, PSCI_NUM_CALLS);
+
+	case ARM_STD_SVC_UID:
+		/* Return UID to the caller */
+		SMC_UUID_RET(handle, arm_svc_uid);
+
+	case ARM_STD_SVC_VERSION:
+		/* Return the version of current implementation */
+		SMC_RET2(handle, STD_SVC_VERSION_MAJOR, STD_SVC_VERSION_MINOR);
+
+	default:
+		WARN("Unimplemented Standard Service Call: 0x%x \n", smc_fid);
+		SMC_RET1(handle, SMC_UNK);
+	}
+}
+
+/*
+ * Function numbers of the Standard Service Calls and their handlers. CPU_SUSPEND
+ * is given its own handler so that it skips the PSCI function switch.
+ */
+static const rt_svc_fid_range_t std_svc_fids[] = {
+	RT_SVC_FID_MASKED_RANGE(PSCI_FID_VALUE, PSCI_FID_MASK,
+				std_svc_psci_handler),
+	RT_SVC_FID(PSCI_CPU_SUSPEND_AARCH64, std_svc_psci_cpu_suspend_handler),
+#if SPM_MM
+	{
+		.first = SPM_MM_FID_MIN_VALUE,
+		.last = SPM_MM_FID_MAX_VALUE,
+		.handle = std_svc_spm_mm_handler
+	},
+#endif
+#if defined(SPD_spmd)
+	{
+		.first = FFA_FNUM_MIN_VALUE,
+		.last = FFA_FNUM_MAX_VALUE,
+		.handle = std_svc_ffa_handler
+	},
+#endif
+#if SDEI_SUPPORT
+	RT_SVC_FID_MASKED_RANGE(SDEI_FID_VALUE, SDEI_FID_MASK,
+				std_svc_sdei_handler),
+#endif
+#if TRNG_SUPPORT
+	{
+		.first = GET_SMC_NUM(ARM_TRNG_VERSION),
+		.last = GET_SMC_NUM(ARM_TRNG_RND64),
+		.handle = trng_smc_handler
+	},
+#endif
+	{
+		.first = GET_SMC_NUM(ARM_STD_SVC_CALL_COUNT),
+		.last = GET_SMC_NUM(ARM_STD_SVC_VERSION),
+		.cc = RT_SVC_FID_CC_SMC32,
+		.handle = std_svc_query_handler
+	}
+};
+
+/* SMC32 and SMC64 function numbers 0x0000-0x00ff, SMC32 0xff00-0xffff */
+DEFINE_RT_SVC_FID_TABLE(std_svc_fid_table, std_svc_fids, 3U);
+
 /* Setup Standard Services */
 static int32_t std_svc_setup(void)
 {
 	uintptr_t svc_arg;
 	int ret = 0;
 
+	if (rt_svc_fid_table_init(&std_svc_fid_table) != 0) {
+		return 1;
+	}
+
 	svc_arg = get_arm_std_svc_args(PSCI_FID_MASK);
 	assert(svc_arg);
 
@@ -71,7 +284,7 @@ static int32_t std_svc_setup(void)
 
 /*
  * Top-level Standard Service SMC handler. This handler will in turn dispatch
- * calls to PSCI SMC handler
+ * calls to the handler std_svc_fids lists for the function number
  */
 static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 			     u_register_t x1,
@@ -82,93 +295,15 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 			     void *handle,
 			     u_register_t flags)
 {
-	/*
-	 * Dispatch PSCI calls to PSCI SMC handler and return its return
-	 * value
-	 */
-	if (is_psci_fid(smc_fid)) {
-		uint64_t ret;
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
+	rt_svc_handle_t handler = rt_svc_fid_lookup(&std_svc_fid_table,
+						    smc_fid);
 
-		/*
-		 * Flush cache line so that even if CPU power down happens
-		 * the timestamp update is reflected in memory.
-		 */
-		PMF_WRITE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_ENTER_PSCI,
-		    PMF_CACHE_MAINT,
-		    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
-#endif
-
-		ret = psci_smc_handler(smc_fid, x1, x2, x3, x4,
-		    cookie, handle, flags);
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_EXIT_PSCI,
-		    PMF_NO_CACHE_MAINT);
-#endif
-
-		SMC_RET1(handle, ret);
-	}
-
-#if SPM_MM
-	/*
-	 * Dispatch SPM calls to SPM SMC handler and return its return
-	 * value
-	 */
-	if (is_spm_mm_fid(smc_fid)) {
-		return spm_mm_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
-					  handle, flags);
-	}
-#endif
-
-#if defined(SPD_spmd)
-	/*
-	 * Dispatch FFA calls to the FFA SMC handler implemented by the SPM
-	 * dispatcher and return its return value
-	 */
-	if (is_ffa_fid(smc_fid)) {
-		return spmd_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
-					handle, flags);
-	}
-#endif
-
-#if SDEI_SUPPORT
-	if (is_sdei_fid(smc_fid)) {
-		return sdei_smc_handler(smc_fid, x1, x2, x3, x4, cookie, handle,
-				flags);
-	}
-#endif
-
-#if TRNG_SUPPORT
-	if (is_trng_fid(smc_fid)) {
-		return trng_smc_handler(smc_fid, x1, x2, x3, x4, cookie, handle,
-				flags);
-	}
-#endif
-
-	switch (smc_fid) {
-	case ARM_STD_SVC_CALL_COUNT:
-		/*
-		 * Return the number of Standard Service Calls. PSCI is the only
-		 * standard service implemented; so return number of PSCI calls
-		 */
-		SMC_RET1(handle, PSCI_NUM_CALLS);
-
-	case ARM_STD_SVC_UID:
-		/* Return UID to the caller */
-		SMC_UUID_RET(handle, arm_svc_uid);
-
-	case ARM_STD_SVC_VERSION:
-		/* Return the version of current implementation */
-		SMC_RET2(handle, STD_SVC_VERSION_MAJOR, STD_SVC_VERSION_MINOR);
-
-	default:
+	if (handler == NULL) {
 		WARN("Unimplemented Standard Service Call: 0x%x \n", smc_fid);
 		SMC_RET1(handle, SMC_UNK);
 	}
+
+	return handler(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
 }
 
 /* Register Standard Service Calls as runtime service */
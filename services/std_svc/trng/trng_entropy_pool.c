@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <lib/lock_prof.h>
 #include <lib/spinlock.h>
 #include <plat/common/plat_trng.h>
 
@@ -26,6 +27,7 @@ static uint32_t entropy_bit_index;
 static uint32_t entropy_bit_size;
 
 static spinlock_t trng_pool_lock;
+REGISTER_LOCK_PROF_LOCK(trng_pool_lock);
 
 #define BITS_PER_WORD (sizeof(entropy[0]) * 8)
 #define BITS_IN_POOL (WORDS_IN_POOL * BITS_PER_WORD)
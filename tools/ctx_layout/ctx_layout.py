@@ -0,0 +1,210 @@
+#!/usr/bin/python3
+# Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""
+This script generates the layout of the EL2 system register block of
+'cpu_context_t' from a table of register groups, so that the offsets, the
+assembly save/restore sequences and the lists used by the C code cannot get
+out of step.
+
+A layout lists the registers a dispatcher switches, split in the groups the
+context management library switches as a unit, and the "host-only" registers
+switched on its fastest path. The host-only registers are placed first so
+that they share a cache line, then come the other registers of every group in
+table order. Adjacent registers of a group are saved and restored with
+stp/ldp.
+
+usage: ctx_layout.py <layout> <output header>
+
+The generated header is checked in. Rerun the script after changing a layout:
+    tools/ctx_layout/ctx_layout.py titanium \\
+        include/lib/el3_runtime/aarch64/context_el2.h
+"""
+
+import sys
+
+# Context slot names which differ from CTX_<REGISTER>
+CTX_NAMES = {
+    "tpidr_el0": "CTX_TPIDR_SEL0",
+    "tpidr_el1": "CTX_TPIDR_SEL1",
+    "par_el1": "CTX_PAR_SEL1",
+}
+
+LAYOUTS = {
+    # Secure EL2 state switched by the TITANIUM dispatcher
+    "titanium": {
+        "groups": [
+            ("TRANS", ["sctlr_el2", "actlr_el2", "vsttbr_el2", "vstcr_el2",
+                       "vttbr_el2", "vtcr_el2", "ttbr0_el2", "mair_el2",
+                       "amair_el2", "tcr_el2", "hcr_el2"]),
+            ("EXCEPT", ["spsr_el2", "elr_el2", "sp_el2", "esr_el2",
+                        "hpfar_el2", "far_el2", "afsr0_el2", "afsr1_el2",
+                        "vbar_el2"]),
+            ("THREAD", ["tpidr_el0", "tpidr_el1", "tpidr_el2", "par_el1",
+                        "contextidr_el2"]),
+            ("TIMER", ["cnthctl_el2", "cnthp_ctl_el2", "cnthp_cval_el2",
+                       "cnthp_tval_el2", "cnthv_ctl_el2", "cnthv_cval_el2",
+                       "cnthv_tval_el2"]),
+        ],
+        # Switched by the KVM trap path, see titanium_helpers.S
+        "host_only": ["ttbr0_el2", "tcr_el2", "sp_el2", "vbar_el2",
+                      "tpidr_el2"],
+    },
+}
+
+# Scratch registers of the generated sequences, x9-x17 as in context.S
+SCRATCH = ["x%d" % i for i in range(9, 18)]
+
+HEADER = """\
+/*
+ * Copyright (c) 2019, Xu Tianqiang. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Generated by tools/ctx_layout/ctx_layout.py from the '%s' layout,
+ * do not edit.
+ */
+
+#ifndef CONTEXT_EL2_H
+#define CONTEXT_EL2_H
+
+#include <lib/utils_def.h>
+"""
+
+
+def ctx_name(reg):
+    return CTX_NAMES.get(reg, "CTX_" + reg.upper())
+
+
+def place(layout):
+    """Return the registers in context order."""
+    order = []
+    for grp, regs in layout["groups"]:
+        order += [r for r in regs if r in layout["host_only"]]
+    for grp, regs in layout["groups"]:
+        order += [r for r in regs if r not in layout["host_only"]]
+    return order
+
+
+def runs(regs, order):
+    """Split 'regs' in chunks of at most two registers adjacent in 'order'."""
+    regs = sorted(regs, key=order.index)
+    chunks = []
+    while regs:
+        if len(regs) > 1 and \
+           order.index(regs[1]) == order.index(regs[0]) + 1:
+            chunks.append(regs[:2])
+            regs = regs[2:]
+        else:
+            chunks.append(regs[:1])
+            regs = regs[1:]
+    return chunks
+
+
+def macro(name, regs, order, save):
+    out = ["\t.macro\t%s base" % name]
+    scratch = 0
+    for chunk in runs(regs, order):
+        xs = []
+        for reg in chunk:
+            xs.append(SCRATCH[scratch % len(SCRATCH)])
+            scratch += 1
+        if save:
+            for x, reg in zip(xs, chunk):
+                out.append("\tmrs\t%s, %s" % (x, reg))
+            op = "stp" if len(chunk) == 2 else "str"
+        else:
+            op = "ldp" if len(chunk) == 2 else "ldr"
+        out.append("\t%s\t%s, [\\base, #%s]" %
+                   (op, ", ".join(xs), ctx_name(chunk[0])))
+        if not save:
+            for x, reg in zip(xs, chunk):
+                out.append("\tmsr\t%s, %s" % (reg, x))
+    out.append("\t.endm")
+    return out
+
+
+def reg_list(name, regs, order):
+    names = [ctx_name(r) for r in sorted(regs, key=order.index)]
+    lines = ["#define %s\t\\" % name]
+    line = "\t"
+    for i, n in enumerate(names):
+        item = n + (", " if i < len(names) - 1 else "")
+        if len(line) + len(item.rstrip()) > 72:
+            lines.append(line.rstrip() + "\t\\")
+            line = "\t"
+        line += item
+    lines.append(line)
+    return lines
+
+
+def generate(name, layout):
+    order = place(layout)
+    out = [HEADER % name]
+
+    out.append("/* Offsets in the 'el2_sys_regs' block */")
+    for i, reg in enumerate(order):
+        out.append("#define %-23s U(0x%x)" % (ctx_name(reg), i * 8))
+    # Align to the next 16 byte boundary
+    end = (len(order) * 8 + 15) & ~15
+    out.append("#define %-23s U(0x%x)" % ("CTX_EL2_SYSREGS_END", end))
+    out.append("")
+
+    out.append("/* Register groups, each saved and restored as a unit */")
+    host_grps = []
+    for i, (grp, regs) in enumerate(layout["groups"]):
+        out.append("#define %-23s U(%d)" % ("CTX_EL2_GRP_" + grp, i))
+        if any(r in layout["host_only"] for r in regs):
+            host_grps.append(grp)
+    out.append("#define %-23s U(%d)" %
+               ("CTX_EL2_GRP_COUNT", len(layout["groups"])))
+    out.append("")
+    out.append("#define CTX_EL2_GRP_BIT(grp)\t(U(1) << (grp))")
+    out.append("#define CTX_EL2_GRPS_ALL\t((U(1) << CTX_EL2_GRP_COUNT) - U(1))")
+    out.append("")
+    out.append("/* Groups touched by the host-only save and restore */")
+    mask = " | \\\n\t\t\t\t ".join("CTX_EL2_GRP_BIT(CTX_EL2_GRP_%s)" % g
+                                  for g in host_grps)
+    out.append("#define CTX_EL2_GRPS_HOST_ONLY\t(%s)" % mask)
+    out.append("")
+
+    out.append("/* Context offsets of the registers of every group */")
+    for grp, regs in layout["groups"]:
+        out += reg_list("CTX_EL2_GRP_%s_REGS" % grp, regs, order)
+    out += reg_list("CTX_EL2_HOST_ONLY_REGS", layout["host_only"], order)
+    out.append("#define %-23s U(%d)" %
+               ("CTX_EL2_HOST_ONLY_COUNT", len(layout["host_only"])))
+    out.append("")
+
+    out.append("#ifdef __ASSEMBLER__")
+    out.append("")
+    out.append("/*")
+    out.append(" * Save or restore registers of the 'el2_sys_regs' block at "
+               "'base', only")
+    out.append(" * using x9-x17 as scratch.")
+    out.append(" */")
+    seqs = [("all", order)]
+    seqs += [(grp.lower(), regs) for grp, regs in layout["groups"]]
+    seqs.append(("host_only", layout["host_only"]))
+    for seq, regs in seqs:
+        out += macro("el2_sysregs_%s_save_regs" % seq, regs, order, True)
+        out.append("")
+        out += macro("el2_sysregs_%s_restore_regs" % seq, regs, order, False)
+        out.append("")
+    out.append("#endif /* __ASSEMBLER__ */")
+    out.append("")
+    out.append("#endif /* CONTEXT_EL2_H */")
+    return "\n".join(out) + "\n"
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3 or sys.argv[1] not in LAYOUTS:
+        sys.exit("usage: %s {%s} <output header>" %
+                 (sys.argv[0], ",".join(sorted(LAYOUTS))))
+
+    with open(sys.argv[2], "w") as out_file:
+        out_file.write(generate(sys.argv[1], LAYOUTS[sys.argv[1]]))